@@ -20,6 +20,7 @@ stdenv.mkDerivation rec {
   name = firmware_name;
   srcs = [
     (firmware_path + ("/" + firmware_name))
+    (firmware_path + "/modules")
     (fetchSWH {
       swhid = "2d14aee3b8b21563a0900f4ac7e0c8f935a9449b";
       sha256 = "1dzhnn6jqwpd5np24zss6wd7s4malq0fixwxjshm8p973bh5i865";
@@ -52,12 +53,17 @@ stdenv.mkDerivation rec {
     chmod +w -R cpu/stm32/include/vendor/cmsis/f1/
     echo '2948138428461c0621fd53b269862c6e6bb043ce' > cpu/stm32/include/vendor/cmsis/f1/.pkg-state.git-downloaded
     find ./cpu/stm32/include/vendor/ -type f -exec md5sum {} \; &> log_orig.txt
+    # packet buffer occupancy for the bufstats module
+    cat ${./pktbuf_usage.c} >> sys/net/gnrc/pktbuf_static/gnrc_pktbuf_static.c
+    # reassembly buffer occupancy for the border router forwarding counters
+    cat ${./frag_rb_usage.c} >> sys/net/gnrc/network_layer/sixlowpan/frag/rb/gnrc_sixlowpan_frag_rb.c
   '';
 
   buildPhase = ''
     export OBJCOPY="arm-none-eabi-objcopy";
     export RIOTBASE=../../
     cp -r ../${name} examples/;
+    cp -r ../modules examples/;
     make -C examples/${name}/;
     find ./cpu/stm32/include/vendor/ -type f -exec md5sum {} \; &> log.txt
   '';
@@ -0,0 +1,23 @@
+
+/*
+ * Appended to sys/net/gnrc/network_layer/sixlowpan/frag/rb/gnrc_sixlowpan_frag_rb.c
+ * by the firmware builder: the reassembly buffer is static to that file.
+ * Used by the border router to report the reassembly buffer occupancy.
+ */
+void gnrc_sixlowpan_frag_rb_usage(unsigned *used, size_t *bytes);
+
+void gnrc_sixlowpan_frag_rb_usage(unsigned *used, size_t *bytes)
+{
+    unsigned entries = 0;
+    size_t received = 0;
+
+    /* only read by the caller, a slightly stale value is fine */
+    for (unsigned i = 0; i < CONFIG_GNRC_SIXLOWPAN_FRAG_RBUF_SIZE; i++) {
+        if (rbuf[i].pkt != NULL) {
+            entries++;
+            received += rbuf[i].super.current_size;
+        }
+    }
+    *used = entries;
+    *bytes = received;
+}
@@ -0,0 +1,24 @@
+
+/*
+ * Appended to sys/net/gnrc/pktbuf_static/gnrc_pktbuf_static.c by the
+ * firmware builder: the free list is static to that file. Used by the
+ * bufstats module to report the packet buffer occupancy.
+ */
+void gnrc_pktbuf_usage(size_t *used, size_t *largest_free);
+
+void gnrc_pktbuf_usage(size_t *used, size_t *largest_free)
+{
+    size_t unused = 0;
+    size_t largest = 0;
+
+    mutex_lock(&_mutex);
+    for (_unused_t *ptr = _first_unused; ptr != NULL; ptr = ptr->next) {
+        unused += ptr->size;
+        if (ptr->size > largest) {
+            largest = ptr->size;
+        }
+    }
+    mutex_unlock(&_mutex);
+    *used = CONFIG_GNRC_PKTBUF_SIZE - unused;
+    *largest_free = largest;
+}
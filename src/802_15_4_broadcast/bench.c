@@ -0,0 +1,319 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Raw 802.15.4 throughput benchmark
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "evlog.h"
+#include "payload_hdr.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/ieee802154.h"
+
+#include "bench.h"
+
+/* pause after a full packet buffer when sending back to back, rather than
+ * spinning until the interface frees some */
+#define BENCH_RETRY_US      (1000U)
+
+#if CONFIG_BENCH_REPORT_MS > UINT16_MAX
+#error "CONFIG_BENCH_REPORT_MS must fit the 16 bit interval of the reports"
+#endif
+
+/* Counters of the sender over one interval */
+typedef struct __attribute__((packed)) {
+    uint8_t size;
+    uint32_t offered;
+    uint32_t sent;
+    uint32_t dropped_src;
+    uint32_t dropped_stack;
+    uint16_t interval_ms;
+} _tx_report_t;
+
+EVLOG_CHECK_SIZE(_tx_report_t);
+
+/* Counters of one sender over one interval, as seen by a receiver */
+typedef struct __attribute__((packed)) {
+    uint16_t node_id;
+    uint8_t size;           /* of the last frame */
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t lost;
+    uint16_t interval_ms;
+} _rx_report_t;
+
+EVLOG_CHECK_SIZE(_rx_report_t);
+
+typedef struct {
+    _rx_report_t report;
+    uint32_t last_seq;
+    bool used;
+} _sender_t;
+
+static uint8_t _frame[IEEE802154_FRAME_LEN_MAX];
+static _sender_t _senders[CONFIG_BENCH_SENDERS];
+static uint32_t _untracked;
+static uint32_t _rx_start;
+
+static void _print_tx(const evlog_rec_t *rec)
+{
+    _tx_report_t r;
+
+    memcpy(&r, rec->data, sizeof(r));
+    printf("bench_tx,%u,%lu,%lu,%lu,%lu,%lu\n", r.size,
+           (unsigned long)r.offered, (unsigned long)r.sent,
+           (unsigned long)r.dropped_src, (unsigned long)r.dropped_stack,
+           r.interval_ms ? (unsigned long)((uint64_t)r.sent * 1000 /
+                                           r.interval_ms) : 0UL);
+}
+
+static void _print_rx(const evlog_rec_t *rec)
+{
+    _rx_report_t r;
+    uint32_t total;
+    unsigned loss = 0;
+
+    memcpy(&r, rec->data, sizeof(r));
+    total = r.frames + r.lost;
+    if (total > 0) {
+        loss = ((uint64_t)r.lost * 1000 + total / 2) / total;
+    }
+    printf("bench_rx,%u,%u,%lu,%lu,%lu,%lu,%u.%u\n", r.node_id, r.size,
+           (unsigned long)r.frames,
+           r.interval_ms ? (unsigned long)((uint64_t)r.frames * 1000 /
+                                           r.interval_ms) : 0UL,
+           r.interval_ms ? (unsigned long)((uint64_t)r.bytes * 8000 /
+                                           r.interval_ms) : 0UL,
+           (unsigned long)r.lost, loss / 10, loss % 10);
+}
+
+static void _print_untracked(const evlog_rec_t *rec)
+{
+    uint32_t frames;
+
+    memcpy(&frames, rec->data, sizeof(frames));
+    printf("bench_rx,untracked,%lu\n", (unsigned long)frames);
+}
+
+void bench_print_headers(void)
+{
+    evlog_puts("bench_tx,Size,Offered,Sent,Dropped at source,"
+               "Dropped in stack,Frames/s");
+    evlog_puts("bench_rx,Sender,Size,Frames,Frames/s,Goodput (bit/s),Lost,"
+               "Loss (%)");
+}
+
+static uint16_t _node_id(const gnrc_netif_t *netif)
+{
+    if (netif->l2addr_len < 2) {
+        return 0;
+    }
+    return (netif->l2addr[netif->l2addr_len - 2] << 8) |
+           netif->l2addr[netif->l2addr_len - 1];
+}
+
+static size_t _max_size(const gnrc_netif_t *netif)
+{
+    uint16_t max;
+
+    if ((gnrc_netapi_get(netif->pid, NETOPT_MAX_PDU_SIZE, 0, &max,
+                         sizeof(max)) == sizeof(max)) &&
+        (max <= sizeof(_frame))) {
+        return max;
+    }
+    /* worst case MAC header */
+    return IEEE802154_FRAME_LEN_MAX - IEEE802154_MAX_HDR_LEN -
+           IEEE802154_FCS_LEN;
+}
+
+/* Broadcasts the first len bytes of _frame */
+static int _send(const gnrc_netif_t *netif, size_t len)
+{
+    gnrc_pktsnip_t *pkt, *hdr;
+
+    pkt = gnrc_pktbuf_add(NULL, _frame, len, GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        return -ENOBUFS;
+    }
+    hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    if (hdr == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return -ENOBUFS;
+    }
+    ((gnrc_netif_hdr_t *)hdr->data)->flags = GNRC_NETIF_HDR_FLAGS_BROADCAST;
+    LL_PREPEND(pkt, hdr);
+    if (gnrc_netapi_send(netif->pid, pkt) < 1) {
+        gnrc_pktbuf_release(pkt);
+        return -EIO;
+    }
+    return 0;
+}
+
+void bench_send_loop(gnrc_netif_t *netif)
+{
+    const size_t max = _max_size(netif);
+    size_t size = CONFIG_BENCH_SIZE;
+    payload_hdr_t hdr = {
+        .gen = PAYLOAD_GEN_PERIODIC,
+        .node_id = _node_id(netif),
+    };
+    _tx_report_t report = { 0 };
+    unsigned step_frames = 0;
+    xtimer_ticks32_t wakeup = xtimer_now();
+    uint32_t start = xtimer_now_usec();
+
+    if ((size == 0) || (size > max)) {
+        size = max;
+    }
+    if ((CONFIG_BENCH_SWEEP_STEP > 0) || (size < PAYLOAD_HDR_LEN)) {
+        size = PAYLOAD_HDR_LEN;
+    }
+    /* filler after the header */
+    for (size_t i = 0; i < sizeof(_frame); i++) {
+        _frame[i] = i;
+    }
+
+    while (1) {
+        uint32_t now;
+        int res;
+
+        if (CONFIG_BENCH_INTERVAL_US > 0) {
+            xtimer_periodic_wakeup(&wakeup, CONFIG_BENCH_INTERVAL_US);
+        }
+        hdr.time = xtimer_now_usec();
+        payload_hdr_write(_frame, size, &hdr);
+        report.offered++;
+        res = _send(netif, size);
+        if (res == 0) {
+            /* gaps at the receivers are frames the interface accepted */
+            hdr.seq++;
+            report.sent++;
+        }
+        else if (res == -ENOBUFS) {
+            report.dropped_src++;
+            if (CONFIG_BENCH_INTERVAL_US == 0) {
+                xtimer_usleep(BENCH_RETRY_US);
+            }
+        }
+        else {
+            report.dropped_stack++;
+        }
+
+        now = xtimer_now_usec();
+        if (now - start >= CONFIG_BENCH_REPORT_MS * US_PER_MS) {
+            report.size = size;
+            report.interval_ms = (now - start) / US_PER_MS;
+            evlog_write(_print_tx, &report, sizeof(report));
+            memset(&report, 0, sizeof(report));
+            start = now;
+        }
+
+        if ((CONFIG_BENCH_SWEEP_STEP > 0) &&
+            (++step_frames >= CONFIG_BENCH_SWEEP_FRAMES)) {
+            step_frames = 0;
+            /* the last step is the maximum, whatever the increment */
+            if (size >= max) {
+                size = PAYLOAD_HDR_LEN;
+            }
+            else {
+                size += CONFIG_BENCH_SWEEP_STEP;
+                size = (size > max) ? max : size;
+            }
+        }
+    }
+}
+
+static _sender_t *_sender(uint16_t node_id)
+{
+    _sender_t *unused = NULL;
+
+    for (unsigned i = 0; i < CONFIG_BENCH_SENDERS; i++) {
+        if (!_senders[i].used) {
+            if (unused == NULL) {
+                unused = &_senders[i];
+            }
+        }
+        else if (_senders[i].report.node_id == node_id) {
+            return &_senders[i];
+        }
+    }
+    return unused;
+}
+
+void bench_receive(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *payload = gnrc_pktsnip_search_type(pkt,
+                                                       GNRC_NETTYPE_UNDEF);
+    payload_hdr_t hdr;
+    _sender_t *sender;
+
+    if ((payload == NULL) ||
+        (payload_hdr_read(payload->data, payload->size, &hdr) != 0)) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    sender = _sender(hdr.node_id);
+    if (sender == NULL) {
+        _untracked++;
+    }
+    else if (!sender->used) {
+        sender->used = true;
+        sender->report.node_id = hdr.node_id;
+        sender->last_seq = hdr.seq;
+    }
+    else if (hdr.seq > sender->last_seq) {
+        sender->report.lost += hdr.seq - sender->last_seq - 1;
+        sender->last_seq = hdr.seq;
+    }
+    else if (hdr.seq < sender->last_seq) {
+        /* the sender restarted */
+        sender->last_seq = hdr.seq;
+    }
+    if (sender != NULL) {
+        sender->report.frames++;
+        sender->report.bytes += payload->size;
+        sender->report.size = payload->size;
+    }
+    gnrc_pktbuf_release(pkt);
+}
+
+void bench_report(void)
+{
+    uint32_t now = xtimer_now_usec();
+    uint16_t interval_ms = (now - _rx_start) / US_PER_MS;
+
+    for (unsigned i = 0; i < CONFIG_BENCH_SENDERS; i++) {
+        _sender_t *sender = &_senders[i];
+
+        if (!sender->used) {
+            continue;
+        }
+        sender->report.interval_ms = interval_ms;
+        evlog_write(_print_rx, &sender->report, sizeof(sender->report));
+        sender->report.frames = 0;
+        sender->report.bytes = 0;
+        sender->report.lost = 0;
+    }
+    if (_untracked > 0) {
+        evlog_write(_print_untracked, &_untracked, sizeof(_untracked));
+        _untracked = 0;
+    }
+    _rx_start = now;
+}
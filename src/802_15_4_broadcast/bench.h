@@ -0,0 +1,134 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Raw 802.15.4 throughput benchmark
+ *
+ * Senders broadcast frames carrying the payload_hdr header (node id,
+ * sequence number, send time) at a fixed interval or back to back,
+ * optionally sweeping the payload size up to the limit of the interface.
+ * Receivers count per sender the frames, bytes and sequence gaps, and
+ * report them once per interval:
+ *
+ *     bench_tx,Size,Offered,Sent,Dropped at source,Dropped in stack,Frames/s
+ *     bench_rx,Sender,Size,Frames,Frames/s,Goodput (bit/s),Lost,Loss (%)
+ *
+ * The sequence number only counts the frames the interface accepted, so
+ * the loss seen by a receiver is the loss of the link and of the MAC.
+ *
+ * @}
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Run the benchmark instead of the hello broadcasts
+ */
+#ifndef CONFIG_BENCH
+#define CONFIG_BENCH                0
+#endif
+
+/**
+ * @brief   Send frames, receive only if 0
+ */
+#ifndef CONFIG_BENCH_SEND
+#define CONFIG_BENCH_SEND           1
+#endif
+
+/**
+ * @brief   Time between two frames in us, 0 to send back to back
+ *
+ * Back to back, the sending thread runs below the event log.
+ */
+#ifndef CONFIG_BENCH_INTERVAL_US
+#define CONFIG_BENCH_INTERVAL_US    (10000U)
+#endif
+
+/**
+ * @brief   Payload size in bytes, 0 for the maximum of the interface
+ */
+#ifndef CONFIG_BENCH_SIZE
+#define CONFIG_BENCH_SIZE           (0U)
+#endif
+
+/**
+ * @brief   Payload size increment of the sweep, 0 for a fixed size
+ *
+ * The sweep starts at the header size, adds CONFIG_BENCH_SWEEP_STEP bytes
+ * every CONFIG_BENCH_SWEEP_FRAMES frames up to the maximum of the interface,
+ * then starts over.
+ */
+#ifndef CONFIG_BENCH_SWEEP_STEP
+#define CONFIG_BENCH_SWEEP_STEP     (0U)
+#endif
+
+/**
+ * @brief   Frames sent at each size of the sweep
+ */
+#ifndef CONFIG_BENCH_SWEEP_FRAMES
+#define CONFIG_BENCH_SWEEP_FRAMES   (500U)
+#endif
+
+/**
+ * @brief   Report interval of senders and receivers, in ms
+ */
+#ifndef CONFIG_BENCH_REPORT_MS
+#define CONFIG_BENCH_REPORT_MS      (1000U)
+#endif
+
+/**
+ * @brief   Senders a receiver keeps counters for
+ */
+#ifndef CONFIG_BENCH_SENDERS
+#define CONFIG_BENCH_SENDERS        (16U)
+#endif
+
+/**
+ * @brief   Message type of the report timer of the receiving thread
+ */
+#define BENCH_MSG_TYPE_REPORT       (0xBE01)
+
+/**
+ * @brief   Queue the header lines of the benchmark output
+ */
+void bench_print_headers(void);
+
+/**
+ * @brief   Send frames on @p netif forever
+ */
+void bench_send_loop(gnrc_netif_t *netif);
+
+/**
+ * @brief   Count a received frame and release it
+ *
+ * Frames without the benchmark header are released without being counted.
+ */
+void bench_receive(gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Queue the report of every known sender and start a new interval
+ *
+ * Call from the thread calling bench_receive().
+ */
+void bench_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
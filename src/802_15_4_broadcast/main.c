@@ -6,10 +6,16 @@
  * directory for more details.
  */
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "bench.h"
+#include "bufstats.h"
+#include "evlog.h"
+#include "kernel_defines.h"
 #include "msg.h"
+#include "rxlog.h"
 #include "thread.h"
 #include "shell.h"
 #include "shell_commands.h"
@@ -19,40 +25,53 @@
 #include "net/gnrc/netif/ieee802154.h"
 
 #define SEND_INTERVAL (1)
+/// Print the send counters every SEND_STATS_INTERVAL packets
+#define SEND_STATS_INTERVAL (60)
 #define RCV_QUEUE_SIZE (16)
+/// Back to back, the benchmark sender never sleeps: it runs below the event
+/// log, or the reports would never be printed
+#if CONFIG_BENCH && (CONFIG_BENCH_INTERVAL_US == 0)
+#define SEND_THREAD_PRIORITY (THREAD_PRIORITY_MAIN + 4)
+#else
+#define SEND_THREAD_PRIORITY (THREAD_PRIORITY_MAIN + 2)
+#endif
 
 char dump_thread_stack[512+256];
 char send_thread_stack[512+256];
+char evlog_thread_stack[512+256];
+char rxlog_thread_stack[512+512];
 
 kernel_pid_t send_thread_pid = 0;
 
-static void _dump(gnrc_pktsnip_t *pkt) {
-    /// Iterate though snippets (Linked List)
-    gnrc_pktsnip_t *snip = pkt;
-    /// Payload and header not known
-    gnrc_pktsnip_t *payload = NULL;
-    gnrc_netif_hdr_t *hdr = NULL;
-    
-    while(snip != NULL) {
-        switch(snip->type)  {
-            case GNRC_NETTYPE_UNDEF :
-                /// No specific network type -> payload
-                payload = snip;
-            break;
-            case GNRC_NETTYPE_NETIF :
-                /// Interface data -> header
-                hdr = snip->data;
-                (void) hdr;
-                /// Print payload
-                printf("Received message: '%s'\n", (char*)payload->data);
-            break;
-            default : 
+/// Counters of send_thread
+typedef struct {
+    uint32_t offered;       ///< packets the thread tried to send
+    uint32_t admitted;      ///< packets accepted by the interface
+    uint32_t dropped_src;   ///< no room in the packet buffer
+    uint32_t dropped_stack; ///< refused by the interface
+} send_stats_t;
 
-            break;
-        }
-        snip = snip->next;
-    }
-    gnrc_pktbuf_release(pkt);
+EVLOG_CHECK_SIZE(send_stats_t);
+
+static void _print_msg_type(const evlog_rec_t *rec) {
+    uint16_t type;
+    memcpy(&type, rec->data, sizeof(type));
+    printf("[dump_thread] message received: %d\n", type);
+}
+
+static void _print_send_error(const evlog_rec_t *rec) {
+    int ret;
+    memcpy(&ret, rec->data, sizeof(ret));
+    printf("[send_thread] unable to send: %d\n", ret);
+}
+
+static void _print_send_stats(const evlog_rec_t *rec) {
+    send_stats_t stats;
+    memcpy(&stats, rec->data, sizeof(stats));
+    printf("send_stats,%lu,%lu,%lu,%lu\n", (unsigned long)stats.offered,
+           (unsigned long)stats.admitted, (unsigned long)stats.dropped_src,
+           (unsigned long)stats.dropped_stack);
+    bufstats_print();
 }
 
 void *dump_thread(void *arg)
@@ -64,16 +83,36 @@ void *dump_thread(void *arg)
     gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL, thread_getpid());
     gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &me_reg);
 
+    /// In benchmark mode, count the frames and report once per interval
+    xtimer_t report_timer;
+    msg_t report_msg = { .type = BENCH_MSG_TYPE_REPORT };
+    if (IS_ACTIVE(CONFIG_BENCH)) {
+        bench_report();
+        xtimer_set_msg(&report_timer, CONFIG_BENCH_REPORT_MS * US_PER_MS, &report_msg, thread_getpid());
+    }
+
     msg_t msg;
     while(1) {
         if(msg_receive(&msg) != 1) {
             puts("Unable to receive message");
             continue;
         }
-        printf("[dump_thread] message received: %d\n", msg.type);
         switch(msg.type) {
             case GNRC_NETAPI_MSG_TYPE_RCV :
-                _dump( msg.content.ptr );
+                /// Only copy what the output needs and release the packet,
+                /// the printing is left to the rxlog thread
+                if (IS_ACTIVE(CONFIG_BENCH)) {
+                    bench_receive(msg.content.ptr);
+                } else {
+                    rxlog_put(msg.content.ptr);
+                }
+            break;
+            case BENCH_MSG_TYPE_REPORT :
+                bench_report();
+                xtimer_set_msg(&report_timer, CONFIG_BENCH_REPORT_MS * US_PER_MS, &report_msg, thread_getpid());
+            break;
+            default :
+                evlog_write(_print_msg_type, &msg.type, sizeof(msg.type));
             break;
         }
     }
@@ -85,6 +124,11 @@ void *send_thread(void *arg)
 {
     gnrc_netif_t *ieee802154_netif = arg;
 
+    if (IS_ACTIVE(CONFIG_BENCH)) {
+        bench_send_loop(ieee802154_netif);
+        return NULL;
+    }
+
     /// 0 Adress length means we want to use broadcast
     size_t addr_len = 0;
     uint8_t addr[GNRC_NETIF_L2ADDR_MAXLEN];
@@ -96,32 +140,53 @@ void *send_thread(void *arg)
     
     /// payload
     char message[] = "RIOT says hello.\0";
-    
+
+    send_stats_t stats = { 0 };
+    /// Set while the packet buffer is full, so that it is only reported once
+    bool full = false;
+
     while(1) {
         /// Sleep 1 second
         xtimer_sleep(SEND_INTERVAL);
-        
-        pkt = gnrc_pktbuf_add(NULL, message, sizeof(message), GNRC_NETTYPE_UNDEF);
-        if (pkt == NULL) {
-            puts("ERROR: packet buffer full");
-            return NULL;
+
+        if ((stats.offered > 0) && ((stats.offered % SEND_STATS_INTERVAL) == 0)) {
+            evlog_write(_print_send_stats, &stats, sizeof(stats));
         }
+        stats.offered++;
 
-        hdr = gnrc_netif_hdr_build(NULL, 0, addr, addr_len);
+        /// A full packet buffer drops this packet only: the buffer drains
+        /// as the interface sends, so try again at the next interval
+        pkt = gnrc_pktbuf_add(NULL, message, sizeof(message), GNRC_NETTYPE_UNDEF);
+        hdr = NULL;
+        if (pkt != NULL) {
+            hdr = gnrc_netif_hdr_build(NULL, 0, addr, addr_len);
+            if (hdr == NULL) {
+                gnrc_pktbuf_release(pkt);
+            }
+        }
         if (hdr == NULL) {
-            puts("ERROR: packet buffer full");
-            gnrc_pktbuf_release(pkt);
-            return NULL;
+            stats.dropped_src++;
+            if (!full) {
+                full = true;
+                evlog_puts("ERROR: packet buffer full");
+            }
+            continue;
+        }
+        if (full) {
+            full = false;
+            evlog_puts("[send_thread] packet buffer available again");
         }
         LL_PREPEND(pkt, hdr);
         nethdr = (gnrc_netif_hdr_t *)hdr->data;
         nethdr->flags = flags;
         int ret = gnrc_netapi_send(ieee802154_netif->pid, pkt);
         if (ret < 1) {
-            printf("[send_thread] unable to send: %d\n", ret);
+            stats.dropped_stack++;
+            evlog_write(_print_send_error, &ret, sizeof(ret));
             gnrc_pktbuf_release(pkt);
         } else {
-            puts("[send_thread] sent message");
+            stats.admitted++;
+            evlog_puts("[send_thread] sent message");
         }
     }
     return NULL;
@@ -129,12 +194,21 @@ void *send_thread(void *arg)
 
 int main(void)
 {
+    /// Lowest priority: receiving and sending never wait for the UART
+    evlog_init(evlog_thread_stack, sizeof(evlog_thread_stack), THREAD_PRIORITY_MAIN + 3);
+    if (IS_ACTIVE(CONFIG_BENCH)) {
+        bench_print_headers();
+    } else {
+        rxlog_init(rxlog_thread_stack, sizeof(rxlog_thread_stack), THREAD_PRIORITY_MAIN + 3);
+    }
     thread_create(dump_thread_stack, sizeof(dump_thread_stack), THREAD_PRIORITY_MAIN + 1, THREAD_CREATE_STACKTEST, dump_thread, NULL, "dump_thread");
     
     gnrc_netif_t *netif = NULL;
-    if((netif = gnrc_netif_iter(netif))) {
+    if (IS_ACTIVE(CONFIG_BENCH) && !IS_ACTIVE(CONFIG_BENCH_SEND)) {
+        puts("Benchmark receiver only");
+    } else if((netif = gnrc_netif_iter(netif))) {
         gnrc_netif_t *ieee802154_netif = netif;
-        send_thread_pid = thread_create(send_thread_stack, sizeof(send_thread_stack), THREAD_PRIORITY_MAIN + 2, THREAD_CREATE_STACKTEST, send_thread, ieee802154_netif, "send_thread");
+        send_thread_pid = thread_create(send_thread_stack, sizeof(send_thread_stack), SEND_THREAD_PRIORITY, THREAD_CREATE_STACKTEST, send_thread, ieee802154_netif, "send_thread");
     } else {
         puts("Unable to find netif");
     }
@@ -0,0 +1,227 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Receive log: frames are summarized by the receiving thread
+ *              and printed by a lower priority one
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "evlog.h"
+#include "kernel_defines.h"
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+
+#include "rxlog.h"
+
+#define RXLOG_MASK  (CONFIG_RXLOG_QUEUE_SIZE - 1)
+
+#if (CONFIG_RXLOG_QUEUE_SIZE & RXLOG_MASK) != 0
+#error "CONFIG_RXLOG_QUEUE_SIZE must be a power of two"
+#endif
+
+/* What the output needs of a received frame */
+typedef struct {
+    uint8_t src[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t src_len;
+    uint8_t lqi;
+    int16_t rssi;
+    uint16_t len;                       /* of the whole payload */
+    uint8_t data[CONFIG_RXLOG_DATA_LEN];
+} _rx_rec_t;
+
+typedef struct {
+    uint8_t addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t addr_len;                   /* 0 if the entry is free */
+    int16_t rssi_min;
+    int16_t rssi_max;
+    int32_t rssi_sum;
+    uint32_t lqi_sum;
+    uint32_t frames;
+    uint32_t bytes;
+} _sender_t;
+
+static _rx_rec_t _ring[CONFIG_RXLOG_QUEUE_SIZE];
+/* free-running indexes, the head is only written by rxlog_put(), the tail by
+ * the rxlog thread */
+static volatile unsigned _head;
+static volatile unsigned _tail;
+static volatile uint32_t _dropped;
+
+/* unlocked by rxlog_put() to wake up the rxlog thread */
+static mutex_t _ready = MUTEX_INIT_LOCKED;
+
+static _sender_t _senders[CONFIG_RXLOG_SENDERS];
+static uint32_t _untracked;
+
+void rxlog_put(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *payload = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *netif = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+
+    if ((_head - _tail) >= CONFIG_RXLOG_QUEUE_SIZE) {
+        _dropped++;
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+
+    _rx_rec_t *rec = &_ring[_head & RXLOG_MASK];
+    memset(rec, 0, sizeof(*rec));
+    if (netif != NULL) {
+        gnrc_netif_hdr_t *hdr = netif->data;
+
+        rec->src_len = hdr->src_l2addr_len;
+        if (rec->src_len > sizeof(rec->src)) {
+            rec->src_len = sizeof(rec->src);
+        }
+        memcpy(rec->src, gnrc_netif_hdr_get_src_addr(hdr), rec->src_len);
+        rec->rssi = hdr->rssi;
+        rec->lqi = hdr->lqi;
+    }
+    if (payload != NULL) {
+        rec->len = payload->size;
+        memcpy(rec->data, payload->data,
+               (payload->size < sizeof(rec->data)) ? payload->size
+                                                   : sizeof(rec->data));
+    }
+    gnrc_pktbuf_release(pkt);
+    _head++;
+
+    mutex_unlock(&_ready);
+}
+
+static void _count(const _rx_rec_t *rec)
+{
+    _sender_t *sender = NULL;
+
+    for (unsigned i = 0; i < CONFIG_RXLOG_SENDERS; i++) {
+        _sender_t *entry = &_senders[i];
+
+        if ((entry->addr_len == rec->src_len) &&
+            (memcmp(entry->addr, rec->src, rec->src_len) == 0)) {
+            sender = entry;
+            break;
+        }
+        if ((entry->addr_len == 0) && (sender == NULL)) {
+            sender = entry;
+        }
+    }
+    if (sender == NULL) {
+        _untracked++;
+        return;
+    }
+    if (sender->frames == 0) {
+        memcpy(sender->addr, rec->src, rec->src_len);
+        sender->addr_len = rec->src_len;
+        sender->rssi_min = rec->rssi;
+        sender->rssi_max = rec->rssi;
+    }
+    sender->rssi_min = (rec->rssi < sender->rssi_min) ? rec->rssi
+                                                      : sender->rssi_min;
+    sender->rssi_max = (rec->rssi > sender->rssi_max) ? rec->rssi
+                                                      : sender->rssi_max;
+    sender->rssi_sum += rec->rssi;
+    sender->lqi_sum += rec->lqi;
+    sender->frames++;
+    sender->bytes += rec->len;
+}
+
+static void _print_frame(const _rx_rec_t *rec)
+{
+    size_t len = (rec->len < sizeof(rec->data)) ? rec->len : sizeof(rec->data);
+
+    printf("Received message: '%.*s'\n",
+           (int)strnlen((const char *)rec->data, len), (const char *)rec->data);
+}
+
+static void _report(void)
+{
+    static uint32_t dropped_reported;
+    char addr_str[GNRC_NETIF_L2ADDR_MAXLEN * 3];
+    uint32_t dropped = _dropped;
+
+    for (unsigned i = 0; i < CONFIG_RXLOG_SENDERS; i++) {
+        _sender_t *sender = &_senders[i];
+
+        if (sender->frames == 0) {
+            /* silent for a whole interval: give the entry up */
+            sender->addr_len = 0;
+            continue;
+        }
+        printf("rx_stats,%s,%lu,%lu,%d,%d,%ld,%lu\n",
+               gnrc_netif_addr_to_str(sender->addr, sender->addr_len, addr_str),
+               (unsigned long)sender->frames, (unsigned long)sender->bytes,
+               sender->rssi_min, sender->rssi_max,
+               (long)(sender->rssi_sum / (int32_t)sender->frames),
+               (unsigned long)(sender->lqi_sum / sender->frames));
+        sender->frames = 0;
+        sender->bytes = 0;
+        sender->rssi_sum = 0;
+        sender->lqi_sum = 0;
+    }
+    printf("rx_drops,%lu,%lu\n", (unsigned long)(dropped - dropped_reported),
+           (unsigned long)_untracked);
+    dropped_reported = dropped;
+    _untracked = 0;
+}
+
+static void *_rxlog_thread(void *arg)
+{
+    (void)arg;
+    uint32_t next = xtimer_now_usec() + CONFIG_RXLOG_REPORT_MS * US_PER_MS;
+
+    evlog_output_lock();
+    puts("rx_stats,L2 address,Frames,Bytes,RSSI min (dBm),RSSI max,RSSI mean,"
+         "LQI mean");
+    puts("rx_drops,Ring full,Untracked senders");
+    evlog_output_unlock();
+
+    while (1) {
+        int32_t wait = next - xtimer_now_usec();
+
+        if (wait > 0) {
+            xtimer_mutex_lock_timeout(&_ready, wait);
+        }
+        while (_tail != _head) {
+            const _rx_rec_t *rec = &_ring[_tail & RXLOG_MASK];
+
+            _count(rec);
+            if (IS_ACTIVE(CONFIG_RXLOG_FRAMES)) {
+                evlog_output_lock();
+                _print_frame(rec);
+                evlog_output_unlock();
+            }
+            /* the slot can only be reused once it has been printed */
+            _tail++;
+        }
+        if ((int32_t)(xtimer_now_usec() - next) >= 0) {
+            next += CONFIG_RXLOG_REPORT_MS * US_PER_MS;
+            evlog_output_lock();
+            _report();
+            evlog_output_unlock();
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t rxlog_init(char *stack, int stacksize, uint8_t priority)
+{
+    return thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _rxlog_thread, NULL, "rxlog");
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Receive log: frames are summarized by the receiving thread
+ *              and printed by a lower priority one
+ *
+ * rxlog_put() copies what the output needs from a received packet (source
+ * address, RSSI, LQI, length and the first bytes of the payload) into a
+ * preallocated ring and releases the packet right away, so that the
+ * receiving thread never waits for the UART and the packet buffer never
+ * holds frames that are only waiting to be printed. The rxlog thread
+ * prints the frames, if enabled, and once per interval a line per sender:
+ *
+ *     rx_stats,L2 address,Frames,Bytes,RSSI min (dBm),RSSI max,RSSI mean,LQI mean
+ *     rx_drops,Ring full,Untracked senders
+ *
+ * @}
+ */
+
+#ifndef RXLOG_H
+#define RXLOG_H
+
+#include "net/gnrc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Frames the ring holds, must be a power of two
+ */
+#ifndef CONFIG_RXLOG_QUEUE_SIZE
+#define CONFIG_RXLOG_QUEUE_SIZE     (32U)
+#endif
+
+/**
+ * @brief   Payload bytes kept per frame
+ */
+#ifndef CONFIG_RXLOG_DATA_LEN
+#define CONFIG_RXLOG_DATA_LEN       (20U)
+#endif
+
+/**
+ * @brief   Print a line per received frame
+ */
+#ifndef CONFIG_RXLOG_FRAMES
+#define CONFIG_RXLOG_FRAMES         1
+#endif
+
+/**
+ * @brief   Interval of the `rx_stats` lines in ms
+ */
+#ifndef CONFIG_RXLOG_REPORT_MS
+#define CONFIG_RXLOG_REPORT_MS      (10000U)
+#endif
+
+/**
+ * @brief   Senders the `rx_stats` lines are kept for
+ */
+#ifndef CONFIG_RXLOG_SENDERS
+#define CONFIG_RXLOG_SENDERS        (16U)
+#endif
+
+/**
+ * @brief   Summarize a received packet into the ring and release it
+ *
+ * Never blocks. The frame is counted as dropped if the ring is full.
+ */
+void rxlog_put(gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Start the thread printing the frames
+ *
+ * @return  PID of the thread
+ */
+kernel_pid_t rxlog_init(char *stack, int stacksize, uint8_t priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RXLOG_H */
@@ -0,0 +1,224 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Batching of the ethos uplink
+ *
+ * @}
+ */
+
+#include "kernel_defines.h"
+
+#include "ethos_batch.h"
+
+#if IS_ACTIVE(CONFIG_ETHOS_BATCH)
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ethos.h"
+#include "irq.h"
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "periph/uart.h"
+
+/* the UART of ethos, see ethos_params.h */
+#ifdef ETHOS_UART
+#define BATCH_UART  ETHOS_UART
+#else
+#define BATCH_UART  UART_DEV(0)
+#endif
+
+/* the real functions, see the --wrap flags in Makefile.ethos.conf */
+void __real_uart_write(uart_t uart, const uint8_t *data, size_t len);
+void __real_ethos_send_frame(ethos_t *dev, const uint8_t *data, size_t len,
+                             unsigned frame_type);
+
+static bool _enabled;
+
+/* bytes waiting for the UART, taken by the writers of ethos, which already
+ * hold the output mutex of ethos, and by the flush thread */
+static mutex_t _out = MUTEX_INIT;
+static uint8_t _buf[CONFIG_ETHOS_BATCH_SIZE];
+static size_t _len;
+
+/* stdio text waiting for the packets to be out */
+static mutex_t _text_lock = MUTEX_INIT;
+static uint8_t _text[CONFIG_ETHOS_BATCH_TEXT_SIZE];
+static size_t _text_len;
+static ethos_t *_text_dev;
+
+/* unlocked by the timer to wake up the flush thread */
+static mutex_t _wake = MUTEX_INIT_LOCKED;
+static xtimer_t _timer;
+static bool _armed;
+
+static uint32_t _writes;
+static uint32_t _bytes;
+static uint32_t _flushed_full;
+static uint32_t _text_deferred;
+static uint32_t _text_overflows;
+
+static void _timer_cb(void *arg)
+{
+    (void)arg;
+    mutex_unlock(&_wake);
+}
+
+/* Starts the delay of the buffers, if not running yet */
+static void _arm(void)
+{
+    unsigned state = irq_disable();
+    bool armed = _armed;
+
+    _armed = true;
+    irq_restore(state);
+    if (!armed) {
+        xtimer_set(&_timer, CONFIG_ETHOS_BATCH_DELAY_US);
+    }
+}
+
+/* Must be called with _out held */
+static void _flush(void)
+{
+    if (_len == 0) {
+        return;
+    }
+    __real_uart_write(BATCH_UART, _buf, _len);
+    _writes++;
+    _bytes += _len;
+    _len = 0;
+}
+
+/* Must be called with _text_lock held */
+static void _send_text(void)
+{
+    if (_text_len == 0) {
+        return;
+    }
+    /* the text frames are only printed by the host, they can be merged */
+    __real_ethos_send_frame(_text_dev, _text, _text_len,
+                            ETHOS_FRAME_TYPE_TEXT);
+    _text_len = 0;
+}
+
+void __wrap_uart_write(uart_t uart, const uint8_t *data, size_t len)
+{
+    if (!_enabled || (uart != BATCH_UART) || irq_is_in()) {
+        __real_uart_write(uart, data, len);
+        return;
+    }
+    mutex_lock(&_out);
+    while (len > 0) {
+        size_t n = CONFIG_ETHOS_BATCH_SIZE - _len;
+
+        n = (len < n) ? len : n;
+        memcpy(&_buf[_len], data, n);
+        _len += n;
+        data += n;
+        len -= n;
+        if (_len == CONFIG_ETHOS_BATCH_SIZE) {
+            _flushed_full++;
+            _flush();
+        }
+    }
+    if (_len > 0) {
+        _arm();
+    }
+    mutex_unlock(&_out);
+}
+
+void __wrap_ethos_send_frame(ethos_t *dev, const uint8_t *data, size_t len,
+                             unsigned frame_type)
+{
+    if (!_enabled || (frame_type != ETHOS_FRAME_TYPE_TEXT) || irq_is_in()) {
+        __real_ethos_send_frame(dev, data, len, frame_type);
+        return;
+    }
+    mutex_lock(&_text_lock);
+    _text_dev = dev;
+    if (_text_len + len <= CONFIG_ETHOS_BATCH_TEXT_SIZE) {
+        memcpy(&_text[_text_len], data, len);
+        _text_len += len;
+        _text_deferred += len;
+        _arm();
+    }
+    else {
+        /* keep the order of the output */
+        _text_overflows++;
+        _send_text();
+        __real_ethos_send_frame(dev, data, len, frame_type);
+    }
+    mutex_unlock(&_text_lock);
+}
+
+static void *_flush_thread(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        mutex_lock(&_wake);
+        _armed = false;
+        /* the packets first, then the text held back behind them */
+        mutex_lock(&_out);
+        _flush();
+        mutex_unlock(&_out);
+        mutex_lock(&_text_lock);
+        _send_text();
+        mutex_unlock(&_text_lock);
+        mutex_lock(&_out);
+        _flush();
+        mutex_unlock(&_out);
+    }
+    return NULL;
+}
+
+kernel_pid_t ethos_batch_init(char *stack, int stacksize, uint8_t priority)
+{
+    kernel_pid_t pid;
+
+    _timer.callback = _timer_cb;
+    pid = thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                        _flush_thread, NULL, "ethos_batch");
+    _enabled = pid_is_valid(pid);
+    return pid;
+}
+
+int ethos_batch_cmd(int argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        mutex_lock(&_out);
+        _writes = 0;
+        _bytes = 0;
+        _flushed_full = 0;
+        mutex_unlock(&_out);
+        mutex_lock(&_text_lock);
+        _text_deferred = 0;
+        _text_overflows = 0;
+        mutex_unlock(&_text_lock);
+        return 0;
+    }
+    if (argc > 1) {
+        printf("usage: %s [reset]\n", argv[0]);
+        return 1;
+    }
+
+    puts("ethos_batch,Writes,Bytes,Flushed full,Text deferred (bytes),"
+         "Text overflows");
+    printf("ethos_batch,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%"
+           PRIu32 "\n", _writes, _bytes, _flushed_full, _text_deferred,
+           _text_overflows);
+    return 0;
+}
+
+#endif /* CONFIG_ETHOS_BATCH */
@@ -0,0 +1,92 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Batching of the ethos uplink
+ *
+ * ethos writes every frame to the UART as it comes, a few bytes per
+ * uart_write() call, and the shell output competes for the same line as the
+ * IPv6 packets. With batching, the bytes ethos writes are collected in a
+ * buffer and handed to the UART in one call when the buffer is full or
+ * CONFIG_ETHOS_BATCH_DELAY_US after its first byte, so that the packets of
+ * many nodes reporting at once cross the uplink in a few large writes.
+ * The stdio text is held back in a second buffer and only sent once the
+ * pending packets are out.
+ *
+ * Both are done by wrapping uart_write() and ethos_send_frame() at link
+ * time, see Makefile.ethos.conf. Writes from interrupt context bypass the
+ * buffers, as ethos already allows them to cut the current frame.
+ *
+ * The `ethos_batch` shell command prints:
+ *
+ *     ethos_batch,Writes,Bytes,Flushed full,Text deferred (bytes),Text overflows
+ *
+ * @}
+ */
+
+#ifndef ETHOS_BATCH_H
+#define ETHOS_BATCH_H
+
+#include "sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Batch the writes of the ethos uplink
+ */
+#ifndef CONFIG_ETHOS_BATCH
+#define CONFIG_ETHOS_BATCH              0
+#endif
+
+/**
+ * @brief   Size of the batch buffer in bytes
+ */
+#ifndef CONFIG_ETHOS_BATCH_SIZE
+#define CONFIG_ETHOS_BATCH_SIZE         (1024U)
+#endif
+
+/**
+ * @brief   Longest time a byte waits in the batch buffer, in us
+ */
+#ifndef CONFIG_ETHOS_BATCH_DELAY_US
+#define CONFIG_ETHOS_BATCH_DELAY_US     (2000U)
+#endif
+
+/**
+ * @brief   Size of the buffer of the deferred stdio text in bytes
+ *
+ * Text that does not fit is sent right away, after the text already held.
+ */
+#ifndef CONFIG_ETHOS_BATCH_TEXT_SIZE
+#define CONFIG_ETHOS_BATCH_TEXT_SIZE    (256U)
+#endif
+
+/**
+ * @brief   Start the thread flushing the buffers and enable batching
+ *
+ * Until then, the writes go to the UART unchanged.
+ *
+ * @return  PID of the thread
+ */
+kernel_pid_t ethos_batch_init(char *stack, int stacksize, uint8_t priority);
+
+/**
+ * @brief   Shell command printing (`ethos_batch`) or clearing
+ *          (`ethos_batch reset`) the counters
+ */
+int ethos_batch_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ETHOS_BATCH_H */
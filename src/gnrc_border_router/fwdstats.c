@@ -0,0 +1,202 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Forwarding counters of the border router
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "sched.h"
+
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/sixlowpan/config.h"
+#include "net/ipv6/hdr.h"
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+#include "net/gnrc/sixlowpan/frag/stats.h"
+#endif
+
+#include "bufstats.h"
+#include "fwdstats.h"
+
+#if CONFIG_FWDSTATS_RBUF_USAGE && defined(MODULE_GNRC_SIXLOWPAN_FRAG_RB)
+#define RBUF_USAGE  1
+/* appended to gnrc_sixlowpan_frag_rb.c by the firmware builder */
+void gnrc_sixlowpan_frag_rb_usage(unsigned *used, size_t *bytes);
+#else
+#define RBUF_USAGE  0
+#endif
+
+/* Forwarded traffic of one interface, by PID */
+typedef struct {
+    uint32_t packets;
+    uint32_t bytes;
+} _iface_t;
+
+/* Counters kept elsewhere, at the last reset */
+typedef struct {
+    uint32_t pktbuf_full;
+    uint32_t queue_full;
+    uint32_t rbuf_full;
+    uint32_t frag_full;
+} _base_t;
+
+static _iface_t _ifaces[MAXTHREADS];
+static uint32_t _no_route;
+static _base_t _base;
+
+/* the real function, see the --wrap flag in the Makefile */
+int __real_gnrc_ipv6_nib_get_next_hop_l2addr(const ipv6_addr_t *dst,
+                                             gnrc_netif_t *netif,
+                                             gnrc_pktsnip_t *pkt,
+                                             gnrc_ipv6_nib_nc_t *nce);
+
+int __wrap_gnrc_ipv6_nib_get_next_hop_l2addr(const ipv6_addr_t *dst,
+                                             gnrc_netif_t *netif,
+                                             gnrc_pktsnip_t *pkt,
+                                             gnrc_ipv6_nib_nc_t *nce)
+{
+    /* the NIB may release or queue pkt, read it first. Per packet, this
+     * walks the few snips of pkt and compares the source with the addresses
+     * of each interface, a handful of 16 byte compares next to the NIB
+     * lookup that follows. */
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+    const ipv6_hdr_t *hdr = (ipv6 != NULL) ? ipv6->data : NULL;
+    bool forwarded = (hdr != NULL) &&
+                     (gnrc_netif_get_by_ipv6_addr(&hdr->src) == NULL);
+    size_t bytes = forwarded ? gnrc_pkt_len(ipv6) : 0;
+    int res = __real_gnrc_ipv6_nib_get_next_hop_l2addr(dst, netif, pkt, nce);
+    kernel_pid_t pid;
+    unsigned state;
+
+    if (!forwarded) {
+        return res;
+    }
+    if (res < 0) {
+        gnrc_ipv6_nib_ft_t fte;
+
+        /* -EHOSTUNREACH is also returned while the link-layer address of
+         * the next hop is resolved, the packet possibly queued until then:
+         * only a destination without any route is a no route drop. Not on
+         * the fast path, and without pkt so that no routing protocol is
+         * asked for a route. */
+        if (gnrc_ipv6_nib_ft_get(dst, NULL, &fte) < 0) {
+            state = irq_disable();
+            _no_route++;
+            irq_restore(state);
+        }
+        return res;
+    }
+    pid = gnrc_ipv6_nib_nc_get_iface(nce);
+    if (pid_is_valid(pid)) {
+        state = irq_disable();
+        _ifaces[pid - KERNEL_PID_FIRST].packets++;
+        _ifaces[pid - KERNEL_PID_FIRST].bytes += bytes;
+        irq_restore(state);
+    }
+    return res;
+}
+
+static uint32_t _queue_full(void)
+{
+    uint32_t full = 0;
+
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        bufstats_queue_t queue;
+
+        if (bufstats_queue(pid, &queue)) {
+            full += queue.full;
+        }
+    }
+    return full;
+}
+
+/* Reads the counters kept elsewhere, since boot */
+static void _current(_base_t *cur)
+{
+    bufstats_pktbuf_t pktbuf;
+
+    bufstats_pktbuf(&pktbuf);
+    memset(cur, 0, sizeof(*cur));
+    cur->pktbuf_full = pktbuf.alloc_failed;
+    cur->queue_full = _queue_full();
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG_STATS
+    gnrc_sixlowpan_frag_stats_t *frag = gnrc_sixlowpan_frag_stats_get();
+
+    cur->rbuf_full = frag->rbuf_full;
+    cur->frag_full = frag->frag_full;
+#endif
+}
+
+void fwdstats_reset(void)
+{
+    unsigned state;
+
+    _current(&_base);
+    state = irq_disable();
+    memset(_ifaces, 0, sizeof(_ifaces));
+    _no_route = 0;
+    irq_restore(state);
+}
+
+void fwdstats_print(void)
+{
+    _base_t cur;
+    gnrc_netif_t *netif = NULL;
+
+    puts("fwd_iface,Interface,Packets,Bytes");
+    while ((netif = gnrc_netif_iter(netif))) {
+        unsigned state = irq_disable();
+        _iface_t iface = _ifaces[netif->pid - KERNEL_PID_FIRST];
+
+        irq_restore(state);
+        printf("fwd_iface,%d,%" PRIu32 ",%" PRIu32 "\n", netif->pid,
+               iface.packets, iface.bytes);
+    }
+
+    _current(&cur);
+    puts("fwd_drops,No route,Packet buffer full,Queue full,"
+         "Reassembly buffer full,Fragment buffer full");
+    printf("fwd_drops,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32
+           ",%" PRIu32 "\n", _no_route, cur.pktbuf_full - _base.pktbuf_full,
+           cur.queue_full - _base.queue_full, cur.rbuf_full - _base.rbuf_full,
+           cur.frag_full - _base.frag_full);
+
+#if RBUF_USAGE
+    unsigned used;
+    size_t bytes;
+
+    gnrc_sixlowpan_frag_rb_usage(&used, &bytes);
+    puts("fwd_rbuf,Size,Used,Bytes");
+    printf("fwd_rbuf,%u,%u,%u\n", CONFIG_GNRC_SIXLOWPAN_FRAG_RBUF_SIZE, used,
+           (unsigned)bytes);
+#endif
+}
+
+int fwdstats_cmd(int argc, char **argv)
+{
+    if ((argc >= 2) && (strcmp(argv[1], "reset") == 0)) {
+        fwdstats_reset();
+        return 0;
+    }
+    else if (argc >= 2) {
+        printf("usage: %s [reset]\n", argv[0]);
+        return 1;
+    }
+    fwdstats_print();
+    return 0;
+}
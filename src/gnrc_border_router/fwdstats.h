@@ -0,0 +1,78 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Forwarding counters of the border router
+ *
+ * Counts per outgoing interface the IPv6 packets forwarded for other nodes
+ * and, over all interfaces, the packets dropped for each reason GNRC has:
+ *
+ * - no route: the NIB has no route to the destination,
+ * - packet buffer full: an allocation failed (bufstats),
+ * - queue full: a message could not be queued to a thread (bufstats),
+ * - reassembly: the 6LoWPAN reassembly buffer, or the fragmentation buffer
+ *   when sending, had no free entry (gnrc_sixlowpan_frag_stats).
+ *
+ * The per-interface counters and the no route drops are kept by wrapping
+ * gnrc_ipv6_nib_get_next_hop_l2addr() at link time, which GNRC calls for
+ * every unicast packet it sends: a packet whose source is not an address of
+ * the border router is forwarded. Finding that source costs a walk over
+ * the snips of the packet and over the addresses of the interfaces, per
+ * packet. A packet held while the NIB resolves the link-layer address of
+ * its next hop is neither a drop nor counted as forwarded: the NIB sends it
+ * later without this function. The occupancy of the reassembly buffer
+ * needs gnrc_sixlowpan_frag_rb_usage(), which the firmware builder appends
+ * to RIOT.
+ *
+ * Output of the `fwdstats` shell command, counted since boot or the last
+ * `fwdstats reset`:
+ *
+ *     fwd_iface,Interface,Packets,Bytes
+ *     fwd_drops,No route,Packet buffer full,Queue full,Reassembly buffer full,Fragment buffer full
+ *     fwd_rbuf,Size,Used,Bytes
+ *
+ * @}
+ */
+
+#ifndef FWDSTATS_H
+#define FWDSTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Report the reassembly buffer occupancy
+ */
+#ifndef CONFIG_FWDSTATS_RBUF_USAGE
+#define CONFIG_FWDSTATS_RBUF_USAGE      1
+#endif
+
+/**
+ * @brief   Print the counters
+ */
+void fwdstats_print(void);
+
+/**
+ * @brief   Restart all counters from 0
+ */
+void fwdstats_reset(void);
+
+/**
+ * @brief   Shell command printing (`fwdstats`) or clearing
+ *          (`fwdstats reset`) the counters
+ */
+int fwdstats_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FWDSTATS_H */
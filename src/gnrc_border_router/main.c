@@ -20,12 +20,48 @@
 
 #include <stdio.h>
 
+#include "kernel_defines.h"
 #include "shell.h"
 #include "msg.h"
 
-#define MAIN_QUEUE_SIZE     (8)
+#include "bufstats.h"
+#include "ethos_batch.h"
+#include "fwdstats.h"
+#include "udp_echo.h"
+#include "udp_sink.h"
+
+#ifndef CONFIG_MAIN_QUEUE_SIZE
+#define CONFIG_MAIN_QUEUE_SIZE  (8)
+#endif
+
+#define MAIN_QUEUE_SIZE     CONFIG_MAIN_QUEUE_SIZE
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
+#if IS_ACTIVE(CONFIG_UDP_SINK)
+static char _udp_sink_stack[THREAD_STACKSIZE_DEFAULT];
+#endif
+#if IS_ACTIVE(CONFIG_UDP_ECHO)
+static char _udp_echo_stack[THREAD_STACKSIZE_DEFAULT];
+#endif
+#if IS_ACTIVE(CONFIG_ETHOS_BATCH)
+static char _ethos_batch_stack[THREAD_STACKSIZE_SMALL];
+#endif
+
+static const shell_command_t shell_commands[] = {
+#if IS_ACTIVE(CONFIG_UDP_SINK)
+    { "udp_sink", "print or reset the per-source UDP counters", udp_sink_cmd },
+#endif
+#if IS_ACTIVE(CONFIG_ETHOS_BATCH)
+    { "ethos_batch", "print or reset the ethos batching counters",
+      ethos_batch_cmd },
+#endif
+    { "bufstats", "show the packet buffer and message queue occupancy",
+      bufstats_cmd },
+    { "fwdstats", "show the forwarding counters, `fwdstats reset` clears them",
+      fwdstats_cmd },
+    { NULL, NULL, NULL }
+};
+
 int main(void)
 {
     /* we need a message queue for the thread running the shell in order to
@@ -33,10 +69,27 @@ int main(void)
     msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
     puts("RIOT border router example application");
 
+#if IS_ACTIVE(CONFIG_ETHOS_BATCH)
+    /* below the network interfaces, which keep filling the batch */
+    ethos_batch_init(_ethos_batch_stack, sizeof(_ethos_batch_stack),
+                     THREAD_PRIORITY_MAIN - 4);
+#endif
+
+#if IS_ACTIVE(CONFIG_UDP_SINK)
+    udp_sink_init(_udp_sink_stack, sizeof(_udp_sink_stack),
+                  THREAD_PRIORITY_MAIN - 1);
+    printf("UDP sink listening on port %u\n", CONFIG_UDP_SINK_PORT);
+#endif
+#if IS_ACTIVE(CONFIG_UDP_ECHO)
+    udp_echo_init(_udp_echo_stack, sizeof(_udp_echo_stack),
+                  THREAD_PRIORITY_MAIN - 1);
+    printf("UDP echo listening on port %u\n", CONFIG_UDP_ECHO_PORT);
+#endif
+
     /* start shell */
     puts("All up, running the shell now");
     char line_buf[SHELL_DEFAULT_BUFSIZE];
-    shell_run(NULL, line_buf, SHELL_DEFAULT_BUFSIZE);
+    shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
 
     /* should be never reached */
     return 0;
@@ -0,0 +1,112 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       UDP echo for the uplink benchmark
+ *
+ * @}
+ */
+
+#include "msg.h"
+#include "utlist.h"
+
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/udp.h"
+#include "net/ipv6/hdr.h"
+#include "net/udp.h"
+
+#include "udp_echo.h"
+
+/* Returns the reply to the request @p pkt, NULL if out of packet buffer */
+static gnrc_pktsnip_t *_reply(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *udp,
+                              gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *netif)
+{
+    uint16_t port = byteorder_ntohs(((udp_hdr_t *)udp->data)->src_port);
+    gnrc_pktsnip_t *reply;
+    gnrc_pktsnip_t *hdr;
+
+    /* the first snip of a received packet is the UDP payload */
+    reply = gnrc_pktbuf_add(NULL, pkt->data, pkt->size, GNRC_NETTYPE_UNDEF);
+    if (reply == NULL) {
+        return NULL;
+    }
+    hdr = gnrc_udp_hdr_build(reply, CONFIG_UDP_ECHO_PORT, port);
+    if (hdr == NULL) {
+        gnrc_pktbuf_release(reply);
+        return NULL;
+    }
+    reply = hdr;
+    hdr = gnrc_ipv6_hdr_build(reply, NULL, &((ipv6_hdr_t *)ipv6->data)->src);
+    if (hdr == NULL) {
+        gnrc_pktbuf_release(reply);
+        return NULL;
+    }
+    reply = hdr;
+    if (netif != NULL) {
+        /* answer on the interface of the request, for link-local sources */
+        gnrc_netif_hdr_t *req = netif->data;
+
+        hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+        if (hdr == NULL) {
+            gnrc_pktbuf_release(reply);
+            return NULL;
+        }
+        gnrc_netif_hdr_set_netif(hdr->data, gnrc_netif_get_by_pid(req->if_pid));
+        LL_PREPEND(reply, hdr);
+    }
+    return reply;
+}
+
+static void _echo(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *udp = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_UDP);
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+    gnrc_pktsnip_t *netif = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    gnrc_pktsnip_t *reply = NULL;
+
+    if ((udp != NULL) && (ipv6 != NULL)) {
+        reply = _reply(pkt, udp, ipv6, netif);
+    }
+    gnrc_pktbuf_release(pkt);
+    if ((reply != NULL) &&
+        !gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP, GNRC_NETREG_DEMUX_CTX_ALL,
+                                   reply)) {
+        gnrc_pktbuf_release(reply);
+    }
+}
+
+static void *_udp_echo_thread(void *arg)
+{
+    (void)arg;
+    msg_t msg_queue[CONFIG_UDP_ECHO_MSG_QUEUE_SIZE];
+    gnrc_netreg_entry_t server = GNRC_NETREG_ENTRY_INIT_PID(CONFIG_UDP_ECHO_PORT,
+                                                            thread_getpid());
+    msg_t msg;
+
+    msg_init_queue(msg_queue, CONFIG_UDP_ECHO_MSG_QUEUE_SIZE);
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &server);
+
+    while (1) {
+        msg_receive(&msg);
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            _echo(msg.content.ptr);
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t udp_echo_init(char *stack, int stacksize, uint8_t priority)
+{
+    return thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _udp_echo_thread, NULL, "udp_echo");
+}
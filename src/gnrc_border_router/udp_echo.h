@@ -0,0 +1,64 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       UDP echo for the uplink benchmark
+ *
+ * Sends every UDP datagram received on CONFIG_UDP_ECHO_PORT back to its
+ * source, so that tools/uplink_bench.py can measure the packet rate and
+ * the round-trip time across the uplink with the host clock only.
+ *
+ * @}
+ */
+
+#ifndef UDP_ECHO_H
+#define UDP_ECHO_H
+
+#include <stdint.h>
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Enable the echo
+ */
+#ifndef CONFIG_UDP_ECHO
+#define CONFIG_UDP_ECHO                 0
+#endif
+
+/**
+ * @brief   UDP port to listen on
+ */
+#ifndef CONFIG_UDP_ECHO_PORT
+#define CONFIG_UDP_ECHO_PORT            (7U)
+#endif
+
+/**
+ * @brief   Size of the message queue of the echo thread
+ */
+#ifndef CONFIG_UDP_ECHO_MSG_QUEUE_SIZE
+#define CONFIG_UDP_ECHO_MSG_QUEUE_SIZE  (16U)
+#endif
+
+/**
+ * @brief   Start the echo thread
+ *
+ * @return  PID of the echo thread
+ */
+kernel_pid_t udp_echo_init(char *stack, int stacksize, uint8_t priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UDP_ECHO_H */
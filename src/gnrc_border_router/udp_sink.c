@@ -0,0 +1,235 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       UDP sink counting the traffic of the gnrc_networking nodes
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "xtimer.h"
+
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netreg.h"
+#include "net/ipv6/addr.h"
+#include "net/ipv6/hdr.h"
+
+#include "payload_hdr.h"
+#include "udp_sink.h"
+
+#define UDP_SINK_MASK   (CONFIG_UDP_SINK_NUMOF - 1)
+
+#if (CONFIG_UDP_SINK_NUMOF & UDP_SINK_MASK) != 0
+#error "CONFIG_UDP_SINK_NUMOF must be a power of two"
+#endif
+
+/* generator of the payloads without the measurement header */
+#define UDP_SINK_NO_GEN (0xFFU)
+
+/* Counters of one source address and generator */
+typedef struct {
+    ipv6_addr_t addr;           /* source, unspecified if the slot is free */
+    uint8_t gen;                /* of the payload header, or UDP_SINK_NO_GEN */
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t last_seq;          /* of the payload header, if has_seq */
+    uint32_t gaps;              /* sequence numbers skipped */
+    uint32_t last_rx;           /* xtimer_now_usec() of the last packet */
+    uint32_t iat_min;           /* inter-arrival times in microseconds */
+    uint32_t iat_max;
+    uint64_t iat_sum;
+    bool has_seq;
+} udp_sink_entry_t;
+
+static udp_sink_entry_t _table[CONFIG_UDP_SINK_NUMOF];
+/* packets of sources that did not fit in the table */
+static uint32_t _overflow;
+/* taken by the sink thread per packet and by the shell per entry */
+static mutex_t _lock = MUTEX_INIT;
+
+static unsigned _hash(const ipv6_addr_t *addr, uint8_t gen)
+{
+    /* FNV-1a, the nodes of one PAN mostly differ in the interface id */
+    uint32_t hash = (2166136261U ^ gen) * 16777619U;
+
+    for (unsigned i = 0; i < sizeof(addr->u8); i++) {
+        hash = (hash ^ addr->u8[i]) * 16777619U;
+    }
+    return hash;
+}
+
+/* Linear probing, returns NULL if the flow is new and the table full.
+ * Must be called with _lock held. */
+static udp_sink_entry_t *_lookup(const ipv6_addr_t *addr, uint8_t gen)
+{
+    unsigned slot = _hash(addr, gen);
+
+    for (unsigned i = 0; i < CONFIG_UDP_SINK_NUMOF; i++, slot++) {
+        udp_sink_entry_t *entry = &_table[slot & UDP_SINK_MASK];
+
+        if (ipv6_addr_equal(&entry->addr, addr) && (entry->gen == gen)) {
+            return entry;
+        }
+        if (ipv6_addr_is_unspecified(&entry->addr)) {
+            memset(entry, 0, sizeof(*entry));
+            entry->addr = *addr;
+            entry->gen = gen;
+            entry->iat_min = UINT32_MAX;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void _count(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+    uint32_t now = xtimer_now_usec();
+    udp_sink_entry_t *entry;
+    payload_iter_t it;
+    payload_hdr_t hdr;
+    uint8_t gen = UDP_SINK_NO_GEN;
+    int res;
+
+    if (ipv6 == NULL) {
+        return;
+    }
+    /* the first snip of a received packet is the UDP payload, an aggregate
+     * only carries samples of one generator */
+    payload_iter_init(&it, pkt->data, pkt->size);
+    if (payload_iter_next(&it, &hdr) == 0) {
+        gen = hdr.gen;
+    }
+    mutex_lock(&_lock);
+    entry = _lookup(&((ipv6_hdr_t *)ipv6->data)->src, gen);
+    if (entry == NULL) {
+        _overflow++;
+        mutex_unlock(&_lock);
+        return;
+    }
+    if (entry->packets > 0) {
+        uint32_t iat = now - entry->last_rx;
+
+        entry->iat_sum += iat;
+        if (iat < entry->iat_min) {
+            entry->iat_min = iat;
+        }
+        if (iat > entry->iat_max) {
+            entry->iat_max = iat;
+        }
+    }
+    entry->last_rx = now;
+    entry->packets++;
+    entry->bytes += pkt->size;
+    /* one sample, or all the samples of an aggregate */
+    payload_iter_init(&it, pkt->data, pkt->size);
+    while ((res = payload_iter_next(&it, &hdr)) != -ENOENT) {
+        if ((res < 0) || (hdr.gen != gen)) {
+            continue;
+        }
+        /* only count forward jumps, reordered packets do not fill gaps */
+        if (entry->has_seq && (hdr.seq > entry->last_seq + 1)) {
+            entry->gaps += hdr.seq - entry->last_seq - 1;
+        }
+        if (!entry->has_seq || (hdr.seq > entry->last_seq)) {
+            entry->last_seq = hdr.seq;
+        }
+        entry->has_seq = true;
+    }
+    mutex_unlock(&_lock);
+}
+
+static void *_udp_sink_thread(void *arg)
+{
+    (void)arg;
+    msg_t msg_queue[CONFIG_UDP_SINK_MSG_QUEUE_SIZE];
+    gnrc_netreg_entry_t server = GNRC_NETREG_ENTRY_INIT_PID(CONFIG_UDP_SINK_PORT,
+                                                            thread_getpid());
+    msg_t msg;
+
+    msg_init_queue(msg_queue, CONFIG_UDP_SINK_MSG_QUEUE_SIZE);
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &server);
+
+    while (1) {
+        msg_receive(&msg);
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            _count(msg.content.ptr);
+            gnrc_pktbuf_release(msg.content.ptr);
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t udp_sink_init(char *stack, int stacksize, uint8_t priority)
+{
+    return thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _udp_sink_thread, NULL, "udp_sink");
+}
+
+int udp_sink_cmd(int argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        mutex_lock(&_lock);
+        memset(_table, 0, sizeof(_table));
+        _overflow = 0;
+        mutex_unlock(&_lock);
+        return 0;
+    }
+    if (argc > 1) {
+        printf("usage: %s [reset]\n", argv[0]);
+        return 1;
+    }
+
+    puts("udp_sink,Source,Generator,Packets,Bytes,Last sequence,Gaps,"
+         "Inter-arrival min (us),Inter-arrival max (us),Inter-arrival mean (us)");
+    for (unsigned i = 0; i < CONFIG_UDP_SINK_NUMOF; i++) {
+        char addr_str[IPV6_ADDR_MAX_STR_LEN];
+        udp_sink_entry_t entry;
+
+        /* copy, so that printing does not hold back the sink thread */
+        mutex_lock(&_lock);
+        entry = _table[i];
+        mutex_unlock(&_lock);
+        if (ipv6_addr_is_unspecified(&entry.addr)) {
+            continue;
+        }
+        ipv6_addr_to_str(addr_str, &entry.addr, sizeof(addr_str));
+        printf("udp_sink,%s,", addr_str);
+        if (entry.gen != UDP_SINK_NO_GEN) {
+            printf("%u", entry.gen);
+        }
+        printf(",%" PRIu32 ",%" PRIu32 ",", entry.packets, entry.bytes);
+        if (entry.has_seq) {
+            printf("%" PRIu32 ",%" PRIu32 ",", entry.last_seq, entry.gaps);
+        }
+        else {
+            printf(",,");
+        }
+        if (entry.packets > 1) {
+            printf("%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n", entry.iat_min,
+                   entry.iat_max,
+                   (uint32_t)(entry.iat_sum / (entry.packets - 1)));
+        }
+        else {
+            printf(",,\n");
+        }
+    }
+    printf("udp_sink_overflow,%" PRIu32 "\n", _overflow);
+    return 0;
+}
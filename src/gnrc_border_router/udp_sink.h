@@ -0,0 +1,81 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       UDP sink counting the traffic of the gnrc_networking nodes
+ *
+ * Registers a thread for a UDP port and keeps per-flow counters in a
+ * fixed-size open addressing hash table, so that delivery can be measured
+ * at the DODAG root without forwarding every packet over the uplink. The
+ * nodes have to use a global address of the border router as destination.
+ * A flow is a source address and the generator of the measurement header
+ * of payload_hdr.h, whose sequence numbers also update the gap counters.
+ * Payloads without the header are counted per source address alone.
+ *
+ * @}
+ */
+
+#ifndef UDP_SINK_H
+#define UDP_SINK_H
+
+#include <stdint.h>
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Enable the sink
+ */
+#ifndef CONFIG_UDP_SINK
+#define CONFIG_UDP_SINK                 0
+#endif
+
+/**
+ * @brief   UDP port to listen on, server_port of gnrc_networking
+ */
+#ifndef CONFIG_UDP_SINK_PORT
+#define CONFIG_UDP_SINK_PORT            (1337U)
+#endif
+
+/**
+ * @brief   Number of flows, must be a power of two
+ */
+#ifndef CONFIG_UDP_SINK_NUMOF
+#define CONFIG_UDP_SINK_NUMOF           (64U)
+#endif
+
+/**
+ * @brief   Size of the message queue of the sink thread
+ */
+#ifndef CONFIG_UDP_SINK_MSG_QUEUE_SIZE
+#define CONFIG_UDP_SINK_MSG_QUEUE_SIZE  (16U)
+#endif
+
+/**
+ * @brief   Start the sink thread
+ *
+ * @return  PID of the sink thread
+ */
+kernel_pid_t udp_sink_init(char *stack, int stacksize, uint8_t priority);
+
+/**
+ * @brief   Shell command printing (`udp_sink`) or clearing
+ *          (`udp_sink reset`) the table
+ */
+int udp_sink_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UDP_SINK_H */
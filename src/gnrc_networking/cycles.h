@@ -0,0 +1,64 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Cycle counter used by the on-target benchmarks
+ *
+ * Uses the DWT cycle counter on Cortex-M3 and up. Other platforms (native,
+ * Cortex-M0) fall back to the microsecond timer, CYCLES_UNIT tells which.
+ *
+ * @}
+ */
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <stdint.h>
+
+#include "cpu.h"
+#include "xtimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CPU_ARCH_CORTEX_M3) || defined(CPU_ARCH_CORTEX_M4) || \
+    defined(CPU_ARCH_CORTEX_M4F) || defined(CPU_ARCH_CORTEX_M7)
+#define CYCLES_UNIT     "cycles"
+
+static inline void cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t cycles_now(void)
+{
+    return DWT->CYCCNT;
+}
+#else
+#define CYCLES_UNIT     "us"
+
+static inline void cycles_init(void)
+{
+}
+
+static inline uint32_t cycles_now(void)
+{
+    return xtimer_now_usec();
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CYCLES_H */
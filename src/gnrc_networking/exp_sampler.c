@@ -0,0 +1,95 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Integer sampler for exponentially distributed intervals
+ *
+ * @}
+ */
+
+#include "exp_sampler.h"
+
+/* ln(2) in Q0.32 */
+#define LN2_Q32     (2977044472ULL)
+
+/* round(log2(1 + i / 256) * 2^31), i = 0..256 */
+static const uint32_t _log2_q31[257] = {
+             0,   12078627,   24110347,   36095523,   48034513,   59927671,
+      71775349,   83577893,   95335645,  107048945,  118718126,  130343521,
+     141925456,  153464255,  164960239,  176413723,  187825021,  199194443,
+     210522295,  221808880,  233054496,  244259442,  255424009,  266548488,
+     277633165,  288678325,  299684247,  310651211,  321579490,  332469358,
+     343321082,  354134928,  364911162,  375650043,  386351829,  397016776,
+     407645136,  418237160,  428793095,  439313187,  449797678,  460246807,
+     470660814,  481039932,  491384396,  501694436,  511970279,  522212153,
+     532420281,  542594885,  552736183,  562844395,  572919734,  582962413,
+     592972645,  602950638,  612896598,  622810731,  632693241,  642544327,
+     652364189,  662153025,  671911030,  681638398,  691335320,  701001986,
+     710638585,  720245302,  729822324,  739369832,  748888009,  758377033,
+     767837083,  777268336,  786670965,  796045145,  805391046,  814708840,
+     823998694,  833260775,  842495250,  851702282,  860882034,  870034667,
+     879160341,  888259214,  897331443,  906377184,  915396590,  924389816,
+     933357012,  942298328,  951213914,  960103918,  968968484,  977807760,
+     986621888,  995411012, 1004175273, 1012914810, 1021629764, 1030320272,
+    1038986470, 1047628495, 1056246482, 1064840562, 1073410869, 1081957534,
+    1090480686, 1098980456, 1107456970, 1115910356, 1124340739, 1132748245,
+    1141132997, 1149495118, 1157834731, 1166151954, 1174446910, 1182719716,
+    1190970490, 1199199350, 1207406412, 1215591791, 1223755601, 1231897955,
+    1240018966, 1248118746, 1256197405, 1264255053, 1272291800, 1280307752,
+    1288303019, 1296277705, 1304231918, 1312165761, 1320079339, 1327972754,
+    1335846110, 1343699509, 1351533050, 1359346835, 1367140963, 1374915531,
+    1382670639, 1390406384, 1398122861, 1405820167, 1413498396, 1421157644,
+    1428798003, 1436419566, 1444022426, 1451606675, 1459172403, 1466719700,
+    1474248656, 1481759361, 1489251901, 1496726366, 1504182841, 1511621414,
+    1519042169, 1526445193, 1533830570, 1541198383, 1548548716, 1555881652,
+    1563197273, 1570495661, 1577776895, 1585041058, 1592288229, 1599518487,
+    1606731910, 1613928578, 1621108567, 1628271955, 1635418819, 1642549234,
+    1649663276, 1656761020, 1663842541, 1670907913, 1677957208, 1684990500,
+    1692007863, 1699009366, 1705995083, 1712965083, 1719919439, 1726858219,
+    1733781493, 1740689331, 1747581801, 1754458972, 1761320910, 1768167684,
+    1774999361, 1781816006, 1788617686, 1795404466, 1802176412, 1808933588,
+    1815676059, 1822403888, 1829117139, 1835815874, 1842500157, 1849170050,
+    1855825614, 1862466912, 1869094003, 1875706949, 1882305810, 1888890646,
+    1895461516, 1902018479, 1908561594, 1915090920, 1921606515, 1928108435,
+    1934596739, 1941071483, 1947532725, 1953980519, 1960414922, 1966835990,
+    1973243777, 1979638338, 1986019729, 1992388003, 1998743213, 2005085414,
+    2011414658, 2017730999, 2024034488, 2030325179, 2036603122, 2042868370,
+    2049120974, 2055360984, 2061588451, 2067803426, 2074005959, 2080196099,
+    2086373895, 2092539398, 2098692655, 2104833716, 2110962628, 2117079439,
+    2123184198, 2129276951, 2135357746, 2141426629, 2147483648,
+};
+
+uint32_t exp_sampler_neg_ln_q26(uint32_t rnd)
+{
+    if (rnd == 0) {
+        rnd = 1;
+    }
+
+    /* rnd = 2^msb * (1 + frac) */
+    unsigned msb = 31 - __builtin_clz(rnd);
+    uint32_t frac = (rnd << (31 - msb)) << 1;
+    unsigned idx = frac >> 24;
+    uint32_t lo = _log2_q31[idx];
+    uint32_t hi = _log2_q31[idx + 1];
+    uint32_t log2_q31 = lo + (((uint64_t)(hi - lo) * ((frac >> 8) & 0xFFFF)) >> 16);
+    uint32_t log2_q26 = (msb << 26) + (log2_q31 >> 5);
+
+    /* -ln(rnd / 2^32) = (32 - log2(rnd)) * ln(2) */
+    return (((uint64_t)((32UL << 26) - log2_q26)) * LN2_Q32) >> 32;
+}
+
+uint32_t exp_sampler_sample_us(uint32_t mean_us, uint32_t rnd)
+{
+    /* round to the nearest microsecond */
+    uint64_t sample = ((uint64_t)mean_us * exp_sampler_neg_ln_q26(rnd)
+                       + (1UL << 25)) >> 26;
+
+    return (sample > UINT32_MAX) ? UINT32_MAX : sample;
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Integer sampler for exponentially distributed intervals
+ *
+ * Inverse transform sampling, `-mean * ln(u)`, computed in fixed point: the
+ * logarithm is taken from the position of the most significant bit plus a
+ * table of log2(1 + f) over 256 intervals (257 entries) with linear
+ * interpolation, so no FPU, soft-float or libm is needed. The absolute
+ * error of a sample is below 2e-6 times the mean, on top of the rounding to
+ * 1 us. Samples are bounded by 32 * ln(2) = 22.2 times the mean, like the
+ * float implementation fed with 32 bit uniform numbers.
+ *
+ * The sampler has no RIOT dependency so that it can be validated and
+ * benchmarked on the host with tools/exp_sampler.
+ *
+ * @}
+ */
+
+#ifndef EXP_SAMPLER_H
+#define EXP_SAMPLER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Compute -ln(rnd / 2^32)
+ *
+ * @param[in] rnd   uniformly distributed 32 bit number, 0 is treated as 1
+ *
+ * @return  -ln(rnd / 2^32) in Q6.26 fixed point
+ */
+uint32_t exp_sampler_neg_ln_q26(uint32_t rnd);
+
+/**
+ * @brief   Sample an exponentially distributed interval
+ *
+ * The caller checks that the mean fits: rates below 1 / UINT32_MAX us
+ * (about one packet per 71 minutes) have no 32 bit mean.
+ *
+ * @param[in] mean_us   mean of the distribution (1 / rate) in microseconds
+ * @param[in] rnd       uniformly distributed 32 bit number
+ *
+ * @return  sample in microseconds, saturated to UINT32_MAX
+ */
+uint32_t exp_sampler_sample_us(uint32_t mean_us, uint32_t rnd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EXP_SAMPLER_H */
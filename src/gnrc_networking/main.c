@@ -18,11 +18,14 @@
  * @}
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
+#include "kernel_defines.h"
+#include "mutex.h"
 #include "shell.h"
 #include "msg.h"
 
@@ -31,8 +34,11 @@
 #include "saul_reg.h"
 #include "fmt.h"
 
+/* Measurement header of the payload */
+#include "payload_hdr.h"
+
 /* Inverse Transform Sampling */
-#include "math.h"
+#include "exp_sampler.h"
 #include "random.h"
 
 /* Networking */
@@ -44,15 +50,34 @@
 #include "net/gnrc/udp.h"
 #include "net/ipv6/addr.h"
 #include "net/netif.h"
-#include "net/gnrc/netif.h"
-#include "net/netstats.h"
-#include "net/netstats/neighbor.h"
-#include "net/gnrc/rpl.h"
-#include "net/gnrc/rpl/structs.h"
-#include "net/gnrc/rpl/dodag.h"
+
+/* Network statistics */
+#include "stats.h"
+
+/* Startup */
+#include "ready.h"
+
+/* Event output */
+#include "evlog.h"
+
+/* Trace replay */
+#include "trace.h"
+
+/* Admission control */
+#include "tbucket.h"
+
+/* Packet path latency */
+#include "pathlat.h"
+
+/* Packet buffer and message queue occupancy */
+#include "bufstats.h"
+
+/* Benchmarks */
+#include "cycles.h"
 
 /* Threading */
 #include "thread.h"
+#include "txsched.h"
 #include "xtimer.h"
 
 /* Readline */
@@ -63,6 +88,91 @@
 
 #define min(a,b) (a<=b?a:b)
 
+/* Number of payload bytes shown in the udp,... lines */
+#define PAYLOAD_PREVIEW_LEN 5
+
+/* Run the send path and sampler benchmarks before starting the generators */
+#ifndef CONFIG_BENCH
+#define CONFIG_BENCH 0
+#endif
+#ifndef CONFIG_BENCH_ITERATIONS
+#define CONFIG_BENCH_ITERATIONS 100U
+#endif
+
+/* Start the payloads with node id, sequence number and send time
+ * (payload_hdr.h) instead of random bytes only */
+#ifndef CONFIG_PAYLOAD_HEADER
+#define CONFIG_PAYLOAD_HEADER 0
+#endif
+
+/* Send the samples of each flow in aggregates that fit in one 802.15.4
+ * frame, see payload_hdr.h for the format */
+#ifndef CONFIG_AGGREGATE
+#define CONFIG_AGGREGATE 0
+#endif
+/* UDP payload budget of an aggregate. A 127 byte frame leaves 104 bytes to
+ * 6LoWPAN with long addresses; IPHC with both global addresses inline takes
+ * 34 and the compressed UDP header 7, so 63 are left. Lower it if packets
+ * carry more headers (RPL option, link-layer security). */
+#ifndef CONFIG_AGGREGATE_BUDGET
+#define CONFIG_AGGREGATE_BUDGET 60U
+#endif
+/* Longest time the first sample of an aggregate waits for the others */
+#ifndef CONFIG_AGGREGATE_HOLD_MS
+#define CONFIG_AGGREGATE_HOLD_MS 500U
+#endif
+#if CONFIG_AGGREGATE_BUDGET > UINT8_MAX
+#error "CONFIG_AGGREGATE_BUDGET must fit the one byte sample lengths"
+#endif
+#if CONFIG_AGGREGATE_BUDGET <= PAYLOAD_AGG_HDR_LEN + 1
+#error "CONFIG_AGGREGATE_BUDGET must leave room for a sample and its length"
+#endif
+
+/* Measure the latency of the generated packets at each stage of the packet
+ * path, see pathlat.h */
+#ifndef CONFIG_PATH_LATENCY
+#define CONFIG_PATH_LATENCY 0
+#endif
+#if (CONFIG_AGGREGATE || CONFIG_PATH_LATENCY) && !CONFIG_PAYLOAD_HEADER
+/* both need the send time and sequence number of each sample */
+#undef CONFIG_PAYLOAD_HEADER
+#define CONFIG_PAYLOAD_HEADER 1
+#endif
+
+/* Packets per second a node offers to its stack, over all flows, 0 for no
+ * limit. Packets beyond the rate and CONFIG_TBUCKET_DEPTH are dropped at
+ * the source. */
+#ifndef CONFIG_TBUCKET_RATE
+#define CONFIG_TBUCKET_RATE 0U
+#endif
+#ifndef CONFIG_TBUCKET_DEPTH
+#define CONFIG_TBUCKET_DEPTH 4U
+#endif
+/* Bytes of the packet buffer a flow leaves free when it allocates a packet,
+ * for the headers, the packets waiting in the stack and the RPL and NDP
+ * traffic. 0 disables the backpressure. */
+#ifndef CONFIG_BACKPRESSURE_RESERVE
+#define CONFIG_BACKPRESSURE_RESERVE 0U
+#endif
+
+/* Largest sample that is aggregated, larger ones are sent alone */
+#define AGG_SAMPLE_MAX (CONFIG_AGGREGATE_BUDGET - PAYLOAD_AGG_HDR_LEN - 1)
+
+/* Size of the buffer of the traces uploaded with the `trace` command */
+#ifndef CONFIG_TRACE_BUF_SIZE
+#define CONFIG_TRACE_BUF_SIZE 2048U
+#endif
+
+/* Restart the trace of the TRACE generation type when it ends */
+#ifndef CONFIG_TRACE_LOOP
+#define CONFIG_TRACE_LOOP 1
+#endif
+
+/* Also wait for an echo reply of the server before starting the traffic */
+#ifndef CONFIG_READY_PROBE
+#define CONFIG_READY_PROBE 0
+#endif
+
 static int readline(char *buf, size_t size)
 {
     int curr_pos = 0;
@@ -123,11 +233,11 @@ static int readline(char *buf, size_t size)
 /* Thread printing network stats */
 char stats_thread_stack[THREAD_STACKSIZE_DEFAULT];
 
-/* Exponential sensor thread */
-char exponential_sensors_thread_stack[THREAD_STACKSIZE_DEFAULT];
+/* Thread scheduling the emissions of all generators */
+char sensors_thread_stack[THREAD_STACKSIZE_DEFAULT];
 
-/* Periodic sensor thread */
-char periodic_sensors_thread_stack[THREAD_STACKSIZE_DEFAULT];
+/* Thread printing the events queued by the other threads */
+char evlog_thread_stack[THREAD_STACKSIZE_DEFAULT];
 
 /* Address and port of the destination server */
 #define IPV6_ADDR_MAXLEN 45
@@ -138,24 +248,104 @@ char server_port[5+1] = "1337";
       - EXPONENTIAL
       - HYBRID
       - PERIODIC
+      - TRACE (replay of the trace, on the exponential generator)
 */
 #define GENERATION_TYPE_MAXLEN 11
 char generation_type[GENERATION_TYPE_MAXLEN+1] = "EXPONENTIAL";
 
-/* Parameter for the data generation */
+/* Parameter for the data generation, in millionths to avoid soft-float:
+      - exp_parameter: rate of the exponential generator (packets/s)
+      - period_parameter: period of the periodic generator (s), i.e. in us
+*/
+#define PARAM_SCALE 1000000UL
+/* Smallest rate, in millionths of packets/s, whose mean interval fits the
+ * 32 bit microseconds of the generators and of the token bucket: about one
+ * packet per 71 minutes */
+#define PARAM_RATE_MIN ((uint32_t)(((uint64_t)PARAM_SCALE * US_PER_SEC + \
+                                    UINT32_MAX - 1) / UINT32_MAX))
+
 #define EXP_PARAMETER_MAXLEN 10
+#define EXP_PARAMETER_DEFAULT 250000
 char exp_parameter_str[EXP_PARAMETER_MAXLEN+1] = "";
-float exp_parameter = 0.25;
+uint32_t exp_parameter = EXP_PARAMETER_DEFAULT;
 
 #define PERIOD_PARAMETER_MAXLEN 10
+#define PERIOD_PARAMETER_DEFAULT 1000000
 char period_parameter_str[PERIOD_PARAMETER_MAXLEN+1] = "";
-float period_parameter = 1.0;
+uint32_t period_parameter = PERIOD_PARAMETER_DEFAULT;
 
-/* Payload size */
+/* Payload size of the boot generators, at most what fits in the IPv6
+ * minimum MTU */
 #define PACKET_SIZE_MAXLEN 10
+#define PACKET_SIZE_MAX (1280 - sizeof(ipv6_hdr_t) - sizeof(udp_hdr_t))
 char packet_size_str[PACKET_SIZE_MAXLEN+1] = "";
 int packet_size = 0;
 
+/* Serializes the emissions and the `gen` commands, so that a change of the
+ * generator parameters applies between two emissions */
+static mutex_t gen_lock = MUTEX_INIT;
+static bool gen_paused = false;
+static bool stats_paused = false;
+
+/* Admission control of the flows, protected by gen_lock */
+static tbucket_t gen_bucket;
+static uint32_t gen_limit;          /* packets/s in millionths, 0 for none */
+static uint32_t gen_depth;
+static size_t gen_reserve = CONFIG_BACKPRESSURE_RESERVE;
+static bool gen_dropping = false;   /* the last packet was dropped at source */
+
+/* Node id in the payload header, the last two bytes of the L2 address */
+uint16_t node_id = 0;
+
+#ifdef CONFIG_TRACE_FILE
+/* The trace given with TRACE_FILE, linked into the image as is */
+__asm__(".section .rodata.trace_builtin,\"a\"\n"
+        ".global trace_builtin\n"
+        "trace_builtin:\n"
+        ".incbin \"" CONFIG_TRACE_FILE "\"\n"
+        ".global trace_builtin_end\n"
+        "trace_builtin_end:\n"
+        ".previous\n");
+extern const uint8_t trace_builtin[];
+extern const uint8_t trace_builtin_end[];
+#endif
+
+/* Trace replayed by the trace flows, the built-in one or the last one
+ * uploaded with `trace`. Protected by gen_lock. */
+static uint8_t trace_buf[CONFIG_TRACE_BUF_SIZE];
+static size_t trace_buf_len;
+static const uint8_t *trace_data;
+static size_t trace_len;
+
+/* Parses a non-negative decimal number ("0.25", "3", "1.5") into millionths.
+ * Leaves value untouched and returns -EINVAL if str is not such a number. */
+static int parse_param(const char *str, uint32_t *value)
+{
+    uint64_t integer = 0;
+    uint32_t fraction = 0, scale = PARAM_SCALE;
+    const char *c = str;
+
+    for (; (*c >= '0') && (*c <= '9'); c++) {
+        integer = integer * 10 + (*c - '0');
+        if (integer > UINT32_MAX / PARAM_SCALE) {
+            return -EINVAL;
+        }
+    }
+    if (*c == '.') {
+        for (c++; (*c >= '0') && (*c <= '9'); c++) {
+            if (scale > 1) {
+                scale /= 10;
+                fraction += (*c - '0') * scale;
+            }
+        }
+    }
+    if ((c == str) || (*c != '\0')) {
+        return -EINVAL;
+    }
+    *value = integer * PARAM_SCALE + fraction;
+    return 0;
+}
+
 void btox(char *xp, const uint8_t *bb, int n) 
 {
     const char xx[]= "0123456789ABCDEF";
@@ -163,265 +353,818 @@ void btox(char *xp, const uint8_t *bb, int n)
 }
 
 
-static void send(char *addr_str, char *port_str, uint8_t *data)
+/* Destination of the generated traffic, resolved once by flow_init() */
+typedef struct {
+    ipv6_addr_t addr;       /* destination address */
+    const char *addr_str;   /* destination address for the shell */
+    gnrc_netif_t *netif;    /* outgoing interface, NULL to let IPv6 decide */
+    uint16_t port;          /* destination (and source) UDP port */
+} flow_t;
+
+static flow_t server_flow;
+
+/* Arguments of the udp,... event, formatted by the evlog thread. The
+ * address is copied: the destination can change before the line is
+ * printed. */
+typedef struct {
+    ipv6_addr_t addr;
+    uint16_t size;
+    uint16_t port;
+    uint8_t preview_len;
+    uint8_t preview[PAYLOAD_PREVIEW_LEN];
+} udp_event_t;
+
+EVLOG_CHECK_SIZE(udp_event_t);
+
+static void _print_udp(const evlog_rec_t *rec)
+{
+    udp_event_t event;
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+    char hexstr[2 * PAYLOAD_PREVIEW_LEN + 1];
+
+    memcpy(&event, rec->data, sizeof(event));
+    btox(hexstr, event.preview, event.preview_len << 1);
+    hexstr[event.preview_len << 1] = 0;
+    printf("udp,%u,%s,%u,%s\n", (unsigned)event.size,
+           ipv6_addr_to_str(addr_str, &event.addr, sizeof(addr_str)),
+           (unsigned)event.port, hexstr);
+}
+
+/* Parses the destination once, so that the per-packet path only has to
+ * build the packet. Note that the interface suffix is cut off addr_str. */
+static int flow_init(flow_t *flow, char *addr_str, const char *port_str)
 {
-    gnrc_netif_t *netif = NULL;
     char *iface;
-    uint16_t port;
-    ipv6_addr_t addr;
 
+    flow->netif = NULL;
     iface = ipv6_addr_split_iface(addr_str);
     if ((!iface) && (gnrc_netif_numof() == 1))
     {
-        netif = gnrc_netif_iter(NULL);
+        flow->netif = gnrc_netif_iter(NULL);
     }
     else if (iface)
     {
-        netif = gnrc_netif_get_by_pid(atoi(iface));
+        flow->netif = gnrc_netif_get_by_pid(atoi(iface));
     }
 
     /* parse destination address */
-    if (ipv6_addr_from_str(&addr, addr_str) == NULL)
+    if (ipv6_addr_from_str(&flow->addr, addr_str) == NULL)
     {
         printf("error,unable to parse destination address %s\n", addr_str);
-        return;
+        return -EINVAL;
     }
+    flow->addr_str = addr_str;
     /* parse port */
-    port = atoi(port_str);
-    if (port == 0)
+    flow->port = atoi(port_str);
+    if (flow->port == 0)
     {
         printf("error,unable to parse destination port %s\n", port_str);
-        return;
+        return -EINVAL;
     }
+    return 0;
+}
+
+/* Allocates an uninitialized payload of size bytes, to be filled in place
+ * by the generator */
+static gnrc_pktsnip_t *_alloc_payload(size_t size)
+{
+    gnrc_pktsnip_t *payload;
 
-    gnrc_pktsnip_t *payload, *udp, *ip;
-    unsigned payload_size;
-    /* allocate payload */
-    payload = gnrc_pktbuf_add(NULL, data, packet_size, GNRC_NETTYPE_UNDEF);
+    payload = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
     if (payload == NULL)
     {
-        puts("error,unable to copy data to packet buffer");
-        return;
+        evlog_puts("error,unable to allocate payload in packet buffer");
     }
-    /* store size for output */
-    payload_size = (unsigned)payload->size;
+    return payload;
+}
+
+/* Prepends the headers to payload, releases payload on failure */
+static gnrc_pktsnip_t *_build_packet(const flow_t *flow, gnrc_pktsnip_t *payload)
+{
+    gnrc_pktsnip_t *udp, *ip;
+
     /* allocate UDP header, set source port := destination port */
-    udp = gnrc_udp_hdr_build(payload, port, port);
+    udp = gnrc_udp_hdr_build(payload, flow->port, flow->port);
     if (udp == NULL)
     {
-        puts("error,unable to allocate UDP header");
+        evlog_puts("error,unable to allocate UDP header");
         gnrc_pktbuf_release(payload);
-        return;
+        return NULL;
     }
     /* allocate IPv6 header */
-    ip = gnrc_ipv6_hdr_build(udp, NULL, &addr);
+    ip = gnrc_ipv6_hdr_build(udp, NULL, &flow->addr);
     if (ip == NULL)
     {
-        puts("error,unable to allocate IPv6 header");
+        evlog_puts("error,unable to allocate IPv6 header");
         gnrc_pktbuf_release(udp);
-        return;
+        return NULL;
     }
     /* add netif header, if interface was given */
-    if (netif != NULL)
+    if (flow->netif != NULL)
     {
         gnrc_pktsnip_t *netif_hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
 
-        gnrc_netif_hdr_set_netif(netif_hdr->data, netif);
+        if (netif_hdr == NULL)
+        {
+            evlog_puts("error,unable to allocate netif header");
+            gnrc_pktbuf_release(ip);
+            return NULL;
+        }
+        gnrc_netif_hdr_set_netif(netif_hdr->data, flow->netif);
         ip = gnrc_pkt_prepend(ip, netif_hdr);
     }
+    return ip;
+}
+
+static int send(const flow_t *flow, gnrc_pktsnip_t *payload)
+{
+    gnrc_pktsnip_t *ip;
+    udp_event_t event = {
+        .addr = flow->addr,
+        .size = payload->size,
+        .port = flow->port,
+        .preview_len = min(PAYLOAD_PREVIEW_LEN, payload->size),
+    };
+
+    /* access to `payload` is given up with the send operation below
+     * => take the preview for the output first, it is only formatted
+     * later by the evlog thread */
+    memcpy(event.preview, payload->data, event.preview_len);
+
+    ip = _build_packet(flow, payload);
+    if (ip == NULL)
+    {
+        return -ENOBUFS;
+    }
+    if (IS_ACTIVE(CONFIG_PATH_LATENCY))
+    {
+        /* ip holds payload until it is dispatched */
+        pathlat_dispatch(payload->data, payload->size);
+    }
     /* send packet */
     if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_UDP, GNRC_NETREG_DEMUX_CTX_ALL, ip))
     {
-        puts("error,enable to locate UDP thread");
+        evlog_puts("error,enable to locate UDP thread");
         gnrc_pktbuf_release(ip);
-        return;
+        return -ENOENT;
     }
-    /* access to `payload` was implicitly given up with the send operation above
-         * => use temporary variable for output */
-    
-    /* Limit the payload size  */
-    int n = min(5,packet_size) << 1;
-    char hexstr[n + 1];
-    btox(hexstr, data, n);
-    hexstr[n] = 0;
-    printf("udp,%u,%s,%u,%s\n", payload_size, addr_str, port, hexstr);
+    evlog_write(_print_udp, &event, sizeof(event));
+    return 0;
+}
+
+static uint32_t exponential_distribution(uint32_t mean_us)
+{
+    return exp_sampler_sample_us(mean_us, random_uint32());
 }
 
-static void read_sensor(void)
+/* State of a traffic flow, protected by gen_lock */
+typedef struct {
+    txsched_event_t event;      /* emissions, in the scheduler while queued */
+    flow_t dst;                 /* destination */
+    char dst_str[IPV6_ADDR_MAXLEN+1];   /* dst.addr_str, for the shell */
+    stats_flow_dist_t dist;     /* distribution of the inter-departure times */
+    uint32_t param;             /* rate (packets/s) or period (s), in millionths */
+    uint32_t interval_us;       /* mean or constant time between two packets */
+    uint32_t on_us;             /* mean duration of a burst (on/off) */
+    uint32_t off_us;            /* mean duration of a silence (on/off) */
+    uint64_t burst_end;         /* end of the current burst (on/off) */
+    trace_cursor_t trace;       /* next packet of the trace (trace) */
+    bool trace_loop;            /* restart the trace at its end (trace) */
+    txsched_event_t agg_event;  /* sends the aggregate after the hold time */
+    gnrc_pktsnip_t *agg;        /* aggregate being filled, NULL if none */
+    uint64_t agg_deadline;      /* end of the hold time of the aggregate */
+    uint8_t agg_len;            /* bytes used in agg */
+    bool agg_queued;            /* agg_event is in the scheduler */
+    uint16_t size;              /* payload size */
+    uint32_t seq;               /* sequence number of the next packet */
+    uint32_t offered;           /* samples generated */
+    uint32_t dropped_src;       /* samples refused by the admission control */
+    uint32_t sent;              /* packets handed to the stack */
+    uint32_t bytes;             /* payload bytes handed to the stack */
+    uint32_t dropped_stack;     /* packets that could not be built or sent */
+    bool enabled;               /* started, by generation_type or `flow` */
+    bool queued;                /* event is in the scheduler */
+} generator_t;
+
+/* The traffic flows. 0 and 1 are the exponential and periodic generators of
+ * the boot configuration, the others are stopped until set up with `flow`.
+ * The index is the generator id of the payload header. */
+#if CONFIG_STATS_FLOWS_NUMOF < 2
+#error "CONFIG_STATS_FLOWS_NUMOF must leave room for the two boot generators"
+#endif
+static generator_t generators[CONFIG_STATS_FLOWS_NUMOF];
+
+#define exponential_generator   (generators[PAYLOAD_GEN_EXPONENTIAL])
+#define periodic_generator      (generators[PAYLOAD_GEN_PERIODIC])
+
+static uint16_t _get_node_id(void)
 {
-    uint8_t result[packet_size];
-    random_bytes(result, packet_size);
-    send(server_address, server_port, result);
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+
+    if ((netif == NULL) || (netif->l2addr_len < 2))
+    {
+        return 0;
+    }
+    return (netif->l2addr[netif->l2addr_len - 2] << 8) |
+           netif->l2addr[netif->l2addr_len - 1];
 }
 
-static float exponential_distribution(void)
+/* Counts a sample of gen dropped at the source. The drops are only logged
+ * when they start and stop, so that an overloaded node does not flood its
+ * output. Must be called with gen_lock held. */
+static void _gen_dropped(generator_t *gen, const char *reason)
 {
-    return -(1 / exp_parameter) * log(random_real());
+    gen->dropped_src++;
+    if (!gen_dropping)
+    {
+        gen_dropping = true;
+        evlog_puts(reason);
+    }
 }
 
-/* Reads the sensor in an infinite loop. */
-static void *_run_exponential_sensor_loop(void *arg)
+/* Must be called with gen_lock held */
+static void _gen_admitted(void)
 {
-    (void)arg;
-    while (1)
+    if (gen_dropping)
     {
-        read_sensor();
-        xtimer_usleep((exponential_distribution()) * US_PER_SEC);
+        gen_dropping = false;
+        evlog_puts("info,drops,stop");
     }
-    return NULL;
 }
 
-static void *_run_periodic_sensor_loop(void *arg)
+/* Takes the token of one sample of gen, counts a source drop if the token
+ * bucket has none. Must be called with gen_lock held. */
+static bool _gen_take(generator_t *gen)
 {
-    (void)arg;
-    while (1)
+    if (!tbucket_take(&gen_bucket, xtimer_now_usec64()))
     {
-        read_sensor();
-        xtimer_usleep(period_parameter * US_PER_SEC);
+        _gen_dropped(gen, "info,drops,start,rate limit");
+        return false;
     }
-    return NULL;
+    return true;
 }
 
-static const char *_netstats_module_to_str(uint8_t module)
+/* Allocates a packet of gen if the packet buffer keeps gen_reserve bytes
+ * free after it, counts a source drop otherwise. Must be called with
+ * gen_lock held. */
+static gnrc_pktsnip_t *_gen_alloc(generator_t *gen, size_t size)
 {
-    switch (module)
+    /* the trial allocation of the reserve is not a packet of the stack, it
+     * is kept out of the packet buffer statistics */
+    gnrc_pktsnip_t *payload = bufstats_pktbuf_add_reserve(size, gen_reserve,
+                                                          GNRC_NETTYPE_UNDEF);
+
+    if (payload == NULL)
     {
-    case NETSTATS_LAYER2:
-        return "Layer 2";
-    case NETSTATS_IPV6:
-        return "IPv6";
-    case NETSTATS_ALL:
-        return "all";
-    default:
-        return "Unknown";
+        _gen_dropped(gen, "info,drops,start,packet buffer");
     }
+    return payload;
 }
 
-static int _netif_stats(netif_t *iface, unsigned module)
+/* Writes one sample of gen->size bytes: the measurement header, if any,
+ * then random bytes */
+static void _fill_sample(generator_t *gen, uint8_t *buf)
 {
-    netstats_t *stats;
-    int res = netif_get_opt(iface, NETOPT_STATS, module, &stats, sizeof(&stats));
+    size_t offset = 0;
 
-    if (res < 0)
+    if (IS_ACTIVE(CONFIG_PAYLOAD_HEADER))
     {
-        printf("stats,0,-1,-1,-1,-1,-1,-1,-1,-1\n");
+        /* only samples that got a buffer take a sequence number, so that
+         * gaps at the receiver are losses in the network or send errors */
+        payload_hdr_t hdr = {
+            .gen = gen - generators,
+            .node_id = node_id,
+            .seq = gen->seq++,
+            .time = xtimer_now_usec(),
+        };
+
+        offset = payload_hdr_write(buf, gen->size, &hdr);
+    }
+    random_bytes(buf + offset, gen->size - offset);
+}
+
+/* Hands a payload of gen to the stack and counts it */
+static void _gen_send(generator_t *gen, gnrc_pktsnip_t *payload)
+{
+    size_t size = payload->size;
+
+    if (send(&gen->dst, payload) < 0)
+    {
+        gen->dropped_stack++;
+        return;
+    }
+    gen->sent++;
+    gen->bytes += size;
+}
+
+/* Sends the aggregate of gen, if any. Must be called with gen_lock held. */
+static void _agg_flush(generator_t *gen)
+{
+    gnrc_pktsnip_t *payload = gen->agg;
+
+    if (payload == NULL)
+    {
+        return;
+    }
+    gen->agg = NULL;
+    /* shrinking is done in place */
+    gnrc_pktbuf_realloc_data(payload, gen->agg_len);
+    _gen_send(gen, payload);
+}
+
+/* Appends a sample to the aggregate of gen, which is built in place in the
+ * packet buffer. The aggregate leaves as soon as one more sample of the same
+ * size would not fit in the budget, or CONFIG_AGGREGATE_HOLD_MS after its
+ * first sample. Every sample takes a token, so that the limit is in samples
+ * with or without aggregation. Must be called with gen_lock held. */
+static void _agg_add(generator_t *gen)
+{
+    uint32_t hold = CONFIG_AGGREGATE_HOLD_MS * US_PER_MS;
+    uint8_t *buf;
+
+    /* the size of a trace flow changes from one sample to the next */
+    if ((gen->agg != NULL) &&
+        (gen->agg_len + 1U + gen->size > CONFIG_AGGREGATE_BUDGET))
+    {
+        _agg_flush(gen);
+    }
+    if (!_gen_take(gen))
+    {
+        return;
+    }
+    if (gen->agg == NULL)
+    {
+        gen->agg = _gen_alloc(gen, CONFIG_AGGREGATE_BUDGET);
+        if (gen->agg == NULL)
+        {
+            return;
+        }
+        buf = gen->agg->data;
+        buf[0] = PAYLOAD_AGG_MAGIC;
+        buf[1] = 0;
+        gen->agg_len = PAYLOAD_AGG_HDR_LEN;
+        gen->agg_deadline = xtimer_now_usec64() + hold;
+        if (!gen->agg_queued)
+        {
+            gen->agg_queued = true;
+            txsched_add(&gen->agg_event, hold);
+        }
+    }
+    _gen_admitted();
+    buf = gen->agg->data;
+    buf[gen->agg_len] = gen->size;
+    _fill_sample(gen, &buf[gen->agg_len + 1]);
+    gen->agg_len += 1 + gen->size;
+    buf[1]++;
+    if (gen->agg_len + 1U + gen->size > CONFIG_AGGREGATE_BUDGET)
+    {
+        _agg_flush(gen);
+    }
+}
+
+/* Sends the aggregate at the end of its hold time. An aggregate sent early
+ * because it was full may have been followed by a new one, whose hold time
+ * ends later. */
+static uint32_t _agg_emit(txsched_event_t *event)
+{
+    generator_t *gen = container_of(event, generator_t, agg_event);
+    uint32_t delay = TXSCHED_STOP;
+
+    mutex_lock(&gen_lock);
+    if ((gen->agg != NULL) && (gen->agg_deadline > event->deadline))
+    {
+        delay = gen->agg_deadline - event->deadline;
     }
     else
     {
-        printf("stats,1,%s,%u,%u,%u,%u,%u,%u,%u\n",
-               _netstats_module_to_str(module),
-               (unsigned)stats->rx_count,
-               (unsigned)stats->rx_bytes,
-               (unsigned)(stats->tx_unicast_count + stats->tx_mcast_count),
-               (unsigned)stats->tx_mcast_count,
-               (unsigned)stats->tx_bytes,
-               (unsigned)stats->tx_success,
-               (unsigned)stats->tx_failed);
-        res = 0;
+        _agg_flush(gen);
+        gen->agg_queued = false;
     }
-    return res;
+    mutex_unlock(&gen_lock);
+    return delay;
 }
 
-int rpl_stats(void)
-{
-    printf("rpl_stats,DIO,packets,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dio_rx_ucast_count, gnrc_rpl_netstats.dio_tx_ucast_count,
-           gnrc_rpl_netstats.dio_rx_mcast_count, gnrc_rpl_netstats.dio_tx_mcast_count);
-    printf("rpl_stats,DIO,bytes,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dio_rx_ucast_bytes, gnrc_rpl_netstats.dio_tx_ucast_bytes,
-           gnrc_rpl_netstats.dio_rx_mcast_bytes, gnrc_rpl_netstats.dio_tx_mcast_bytes);
-    printf("rpl_stats,DIS,packets,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dis_rx_ucast_count, gnrc_rpl_netstats.dis_tx_ucast_count,
-           gnrc_rpl_netstats.dis_rx_mcast_count, gnrc_rpl_netstats.dis_tx_mcast_count);
-    printf("rpl_stats,DIS,bytes,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dis_rx_ucast_bytes, gnrc_rpl_netstats.dis_tx_ucast_bytes,
-           gnrc_rpl_netstats.dis_rx_mcast_bytes, gnrc_rpl_netstats.dis_tx_mcast_bytes);
-    printf("rpl_stats,DAO,packets,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dao_rx_ucast_count, gnrc_rpl_netstats.dao_tx_ucast_count,
-           gnrc_rpl_netstats.dao_rx_mcast_count, gnrc_rpl_netstats.dao_tx_mcast_count);
-    printf("rpl_stats,DAO,bytes,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dao_rx_ucast_bytes, gnrc_rpl_netstats.dao_tx_ucast_bytes,
-           gnrc_rpl_netstats.dao_rx_mcast_bytes, gnrc_rpl_netstats.dao_tx_mcast_bytes);
-    printf("rpl_stats,DAO-ACK,packets,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dao_ack_rx_ucast_count, gnrc_rpl_netstats.dao_ack_tx_ucast_count,
-           gnrc_rpl_netstats.dao_ack_rx_mcast_count, gnrc_rpl_netstats.dao_ack_tx_mcast_count);
-    printf("rpl_stats,DAO-ACK,bytes,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
-           gnrc_rpl_netstats.dao_ack_rx_ucast_bytes, gnrc_rpl_netstats.dao_ack_tx_ucast_bytes,
-           gnrc_rpl_netstats.dao_ack_rx_mcast_bytes, gnrc_rpl_netstats.dao_ack_tx_mcast_bytes);
-    return 0;
+static void read_sensor(generator_t *gen)
+{
+    gnrc_pktsnip_t *payload;
+
+    gen->offered++;
+    if (IS_ACTIVE(CONFIG_AGGREGATE) && (gen->size <= AGG_SAMPLE_MAX))
+    {
+        _agg_add(gen);
+        return;
+    }
+    if (!_gen_take(gen))
+    {
+        return;
+    }
+    /* generate the payload directly in the packet buffer */
+    payload = _gen_alloc(gen, gen->size);
+    if (payload == NULL)
+    {
+        return;
+    }
+    _gen_admitted();
+    _fill_sample(gen, payload->data);
+    _gen_send(gen, payload);
 }
 
-int rpl_dodag_show(void)
+/* Takes the generator out of the scheduler if it has been paused or
+ * disabled since it was queued. Must be called with gen_lock held. */
+static bool _gen_stopped(generator_t *gen)
 {
-    for (uint8_t i = 0; i < GNRC_RPL_INSTANCES_NUMOF; ++i) {
-        printf("rpl_status,instance,%d,%d\n", i, gnrc_rpl_instances[i].state);
+    if (gen->enabled && !gen_paused)
+    {
+        return false;
     }
+    gen->queued = false;
+    return true;
+}
 
-    for (uint8_t i = 0; i < GNRC_RPL_PARENTS_NUMOF; ++i) {
-        printf("rpl_status,parent,%d,%d\n", i, gnrc_rpl_parents[i].state);
+/* Replays the trace of TRACE_FILE, if any. Must be called with gen_lock
+ * held or before the scheduler runs. */
+static void _trace_use_builtin(void)
+{
+    trace_data = NULL;
+    trace_len = 0;
+#ifdef CONFIG_TRACE_FILE
+    if (trace_check(trace_builtin, trace_builtin_end - trace_builtin,
+                    NULL, NULL) == 0)
+    {
+        trace_data = trace_builtin;
+        trace_len = trace_builtin_end - trace_builtin;
     }
+#endif
+}
 
-    gnrc_rpl_dodag_t *dodag = NULL;
-    char addr_str[IPV6_ADDR_MAX_STR_LEN];
-    uint64_t tc;
+/* Payload size of a trace packet, within what the flow can send */
+static uint16_t _trace_size(uint16_t size)
+{
+    uint16_t min = IS_ACTIVE(CONFIG_PAYLOAD_HEADER) ? PAYLOAD_HDR_LEN : 0;
+
+    if (size < min)
+    {
+        return min;
+    }
+    return (size > PACKET_SIZE_MAX) ? PACKET_SIZE_MAX : size;
+}
+
+/* Moves a trace flow to its next packet and returns the time to it. At the
+ * end of the trace, the flow stops or starts over. Must be called with
+ * gen_lock held. */
+static uint32_t _gen_trace_next(generator_t *gen)
+{
+    trace_rec_t rec;
+
+    if (trace_next(trace_data, trace_len, &gen->trace, &rec) < 0)
+    {
+        trace_rewind(&gen->trace);
+        if (!gen->trace_loop ||
+            (trace_next(trace_data, trace_len, &gen->trace, &rec) < 0))
+        {
+            evlog_puts("info,trace,done");
+            gen->enabled = false;
+            return TXSCHED_STOP;
+        }
+    }
+    gen->size = _trace_size(rec.size);
+    return min(rec.delta_us, TXSCHED_STOP - 1);
+}
+
+/* Time from the emission due at deadline to the next one. An on/off flow
+ * emits with exponential gaps until the end of its burst, then stays silent
+ * for an exponential off time and starts the next burst with an emission.
+ * A trace flow keeps the recorded gaps, the deadlines being absolute they
+ * do not drift. Must be called with gen_lock held. */
+static uint32_t _gen_delay(generator_t *gen, uint64_t deadline)
+{
+    uint64_t next;
+
+    switch (gen->dist) {
+    case STATS_FLOW_PERIODIC:
+        return gen->interval_us;
+    case STATS_FLOW_ONOFF:
+        next = deadline + exponential_distribution(gen->interval_us);
+        if (next >= gen->burst_end) {
+            next = (gen->burst_end > deadline) ? gen->burst_end : deadline;
+            next += exponential_distribution(gen->off_us);
+            gen->burst_end = next + exponential_distribution(gen->on_us);
+        }
+        return min(next - deadline, (uint64_t)TXSCHED_STOP - 1);
+    case STATS_FLOW_TRACE:
+        return _gen_trace_next(gen);
+    default:
+        return exponential_distribution(gen->interval_us);
+    }
+}
+
+/* Reads the sensor, then waits until the next emission of the flow */
+static uint32_t _gen_emit(txsched_event_t *event)
+{
+    generator_t *gen = container_of(event, generator_t, event);
+    uint32_t delay = TXSCHED_STOP;
+
+    mutex_lock(&gen_lock);
+    if (!_gen_stopped(gen))
+    {
+        read_sensor(gen);
+        delay = _gen_delay(gen, event->deadline);
+        gen->queued = (delay != TXSCHED_STOP);
+    }
+    mutex_unlock(&gen_lock);
+    return delay;
+}
+
+/* Starts a new burst of an on/off flow, or the trace of a trace flow from
+ * its first packet, which leaves right away. Must be called with gen_lock
+ * held. */
+static int _gen_reset(generator_t *gen)
+{
+    trace_rec_t rec;
+
+    switch (gen->dist) {
+    case STATS_FLOW_ONOFF:
+        gen->burst_end = xtimer_now_usec64() +
+                         exponential_distribution(gen->on_us);
+        break;
+    case STATS_FLOW_TRACE:
+        trace_rewind(&gen->trace);
+        if (trace_next(trace_data, trace_len, &gen->trace, &rec) < 0)
+        {
+            return -ENOENT;
+        }
+        gen->size = _trace_size(rec.size);
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/* Queues the generator if it should run and is not queued yet, it emits
+ * right away. Must be called with gen_lock held. */
+static void _gen_start(generator_t *gen)
+{
+    if (gen->enabled && !gen_paused && !gen->queued)
+    {
+        if (_gen_reset(gen) < 0)
+        {
+            puts("error,no trace to replay");
+            gen->enabled = false;
+            return;
+        }
+        gen->queued = true;
+        txsched_add(&gen->event, 0);
+    }
+}
+
+/* A queued generator is rescheduled: the delay to its next emission is drawn
+ * again from now with the new settings, a trace starts right away. param is
+ * ignored for a trace, which keeps the previous one for when the generator
+ * leaves it. Must be called with gen_lock held. */
+static int _gen_set_dist(generator_t *gen, stats_flow_dist_t dist,
+                         uint32_t param)
+{
+    int res;
+
+    if ((dist == STATS_FLOW_TRACE) && (trace_len == 0))
+    {
+        return -ENOENT;
+    }
+    if ((dist != STATS_FLOW_TRACE) && (param == 0))
+    {
+        return -EINVAL;
+    }
+    if ((dist != STATS_FLOW_TRACE) && (dist != STATS_FLOW_PERIODIC) &&
+        (param < PARAM_RATE_MIN))
+    {
+        return -EINVAL;
+    }
+    gen->dist = dist;
+    if (dist != STATS_FLOW_TRACE)
+    {
+        gen->param = param;
+    }
+    if (dist == STATS_FLOW_PERIODIC)
+    {
+        gen->interval_us = param;
+    }
+    else if (dist != STATS_FLOW_TRACE)
+    {
+        gen->interval_us = ((uint64_t)PARAM_SCALE * US_PER_SEC) / param;
+    }
+    res = _gen_reset(gen);
+    if ((res == 0) && gen->queued && gen->enabled && !gen_paused)
+    {
+        uint32_t delay = 0;
 
-    for (uint8_t i = 0; i < GNRC_RPL_INSTANCES_NUMOF; ++i) {
-        if (gnrc_rpl_instances[i].state == 0) {
-            continue;
+        if (dist != STATS_FLOW_TRACE)
+        {
+            delay = _gen_delay(gen, xtimer_now_usec64());
         }
+        txsched_reschedule(&gen->event, delay);
+    }
+    return res;
+}
 
-        dodag = &gnrc_rpl_instances[i].dodag;
+static int _gen_set_size(generator_t *gen, int size)
+{
+    int min = IS_ACTIVE(CONFIG_PAYLOAD_HEADER) ? (int)PAYLOAD_HDR_LEN : 0;
 
-        printf("rpl_stats_instance,%d,%" PRIkernel_pid ",%d,%d,%d,%d\n",
-                gnrc_rpl_instances[i].id, dodag->iface,
-                gnrc_rpl_instances[i].mop, gnrc_rpl_instances[i].of->ocp,
-                gnrc_rpl_instances[i].min_hop_rank_inc, gnrc_rpl_instances[i].max_rank_inc);
+    if ((size < min) || (size > (int)PACKET_SIZE_MAX))
+    {
+        return -EINVAL;
+    }
+    gen->size = size;
+    return 0;
+}
 
-        tc = xtimer_left_usec(&dodag->trickle.msg_timer);
-        tc = (int64_t) tc == 0 ? 0 : tc / US_PER_SEC;
+/* Parses a destination into flow without touching the generators, so that
+ * it can be done outside of gen_lock. buf holds the address string of flow
+ * and has IPV6_ADDR_MAXLEN + 1 bytes. */
+static int _dst_parse(flow_t *flow, char *buf, const char *addr,
+                      const char *port)
+{
+    strncpy(buf, addr, IPV6_ADDR_MAXLEN);
+    buf[IPV6_ADDR_MAXLEN] = '\0';
+    return flow_init(flow, buf, port);
+}
 
-        printf("rpl_stats_dodag,%d,%s,%d,%s,%s,%d,%d,%d,%d,%" PRIu32 "\n", gnrc_rpl_instances[i].id,
-               ipv6_addr_to_str(addr_str, &dodag->dodag_id, sizeof(addr_str)),
-               dodag->my_rank, (dodag->node_status == GNRC_RPL_LEAF_NODE ? "Leaf" : "Router"),
-               ((dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO) ? "on" : "off"),
-               (1 << dodag->dio_min), dodag->dio_interval_doubl, dodag->trickle.k,
-               dodag->trickle.c, (uint32_t) (tc & 0xFFFFFFFF));
+/* Switches gen to a parsed destination between two emissions. The address
+ * string is only read by the shell thread, which is the one changing it.
+ * Must be called with gen_lock held or before the scheduler runs. */
+static void _gen_set_dst(generator_t *gen, const flow_t *flow)
+{
+    gen->dst = *flow;
+    strcpy(gen->dst_str, flow->addr_str);
+    gen->dst.addr_str = gen->dst_str;
+}
 
-        gnrc_rpl_parent_t *parent = NULL;
-        LL_FOREACH(gnrc_rpl_instances[i].dodag.parents, parent) {
-            printf("rpl_stats_parent,%d,%s,%d\n", gnrc_rpl_instances[i].id, ipv6_addr_to_str(addr_str, &parent->addr, sizeof(addr_str)), parent->rank);
+/* Limits the packets of all flows to rate (packets/s in millionths, 0 for
+ * no limit) with bursts of depth packets. Must be called with gen_lock held
+ * or before the scheduler runs. */
+static void _gen_set_limit(uint32_t rate, uint32_t depth)
+{
+    gen_limit = rate;
+    gen_depth = depth;
+    tbucket_init(&gen_bucket,
+                 rate ? ((uint64_t)PARAM_SCALE * US_PER_SEC) / rate : 0,
+                 depth);
+}
+
+/* Sets up the flows from the boot configuration, before the scheduler runs */
+static void _gen_init(void)
+{
+    stats_flow_dist_t dist;
+    uint32_t param, fallback;
+
+    _trace_use_builtin();
+    _gen_set_limit(CONFIG_TBUCKET_RATE * PARAM_SCALE, CONFIG_TBUCKET_DEPTH);
+    for (unsigned i = 0; i < ARRAY_SIZE(generators); i++)
+    {
+        generator_t *gen = &generators[i];
+
+        gen->event.cb = _gen_emit;
+        gen->agg_event.cb = _agg_emit;
+        _gen_set_dst(gen, &server_flow);
+        gen->size = packet_size;
+        gen->on_us = US_PER_SEC;
+        gen->off_us = US_PER_SEC;
+        gen->trace_loop = IS_ACTIVE(CONFIG_TRACE_LOOP);
+        if (i == PAYLOAD_GEN_EXPONENTIAL)
+        {
+            dist = STATS_FLOW_EXPONENTIAL;
+            param = exp_parameter;
+            fallback = EXP_PARAMETER_DEFAULT;
+        }
+        else
+        {
+            dist = STATS_FLOW_PERIODIC;
+            param = period_parameter;
+            fallback = PERIOD_PARAMETER_DEFAULT;
+        }
+        if (_gen_set_dist(gen, dist, param) < 0)
+        {
+            printf("error,wrong parameter for flow %u, using the default\n", i);
+            _gen_set_dist(gen, dist, fallback);
         }
     }
+}
+
+/* Enables the generators of a generation type (a prefix of EXPONENTIAL,
+ * PERIODIC, HYBRID or TRACE). TRACE replays the trace on the exponential
+ * generator. Must be called with gen_lock held. */
+static int _gen_set_type(const char *type)
+{
+    bool exponential, periodic, trace = false;
+
+    if (strncmp(type, "EXPONENTIAL", strlen(type)) == 0) {
+        exponential = true;
+        periodic = false;
+    } else if (strncmp(type, "PERIODIC", strlen(type)) == 0) {
+        exponential = false;
+        periodic = true;
+    } else if (strncmp(type, "HYBRID", strlen(type)) == 0) {
+        exponential = true;
+        periodic = true;
+    } else if (strncmp(type, "TRACE", strlen(type)) == 0) {
+        exponential = true;
+        periodic = false;
+        trace = true;
+    } else {
+        return -EINVAL;
+    }
+    if (trace != (exponential_generator.dist == STATS_FLOW_TRACE)) {
+        int res = _gen_set_dist(&exponential_generator,
+                                trace ? STATS_FLOW_TRACE : STATS_FLOW_EXPONENTIAL,
+                                exponential_generator.param);
+        if (res < 0) {
+            return res;
+        }
+    }
+    exponential_generator.enabled = exponential;
+    periodic_generator.enabled = periodic;
+    _gen_start(&exponential_generator);
+    _gen_start(&periodic_generator);
     return 0;
 }
 
-static void _print_neighbors(netif_t *dev)
+/* Rate or period of a flow as reported, a trace has none */
+static uint32_t _gen_param(const generator_t *gen)
+{
+    return (gen->dist == STATS_FLOW_TRACE) ? 0 : gen->param;
+}
+
+/* Fills the flow_stats,... record of a flow, called by the stats thread */
+static bool _gen_stats(unsigned idx, stats_rec_flow_t *rec)
 {
-    netstats_nb_t *stats = &dev->neighbors.pstats[0];
-    char l2addr_str[3 * L2UTIL_ADDR_MAX_LEN];
-    
-    for (unsigned i = 0; i < NETSTATS_NB_SIZE; ++i) {
-        netstats_nb_t *entry = &stats[i];
+    generator_t *gen;
 
-        if (entry->l2_addr_len == 0) {
-            continue;
+    if (idx >= ARRAY_SIZE(generators))
+    {
+        return false;
+    }
+    gen = &generators[idx];
+    mutex_lock(&gen_lock);
+    rec->id = idx;
+    rec->dist = gen->dist;
+    rec->active = gen->enabled && !gen_paused;
+    rec->size = gen->size;
+    rec->port = gen->dst.port;
+    memcpy(rec->addr, &gen->dst.addr, sizeof(rec->addr));
+    rec->param = _gen_param(gen);
+    rec->sent = gen->sent;
+    rec->bytes = gen->bytes;
+    rec->offered = gen->offered;
+    rec->dropped_src = gen->dropped_src;
+    rec->dropped_stack = gen->dropped_stack;
+    mutex_unlock(&gen_lock);
+    return true;
+}
+
+/* Measures the one-time destination parsing against the per-packet path,
+ * and the cost of one exponential sample */
+static void _bench(void)
+{
+    char addr_str[IPV6_ADDR_MAXLEN+1];
+    uint32_t start, parse = 0, build = 0, sample_cost;
+    volatile uint32_t sample = 0;
+    flow_t flow;
+
+    cycles_init();
+    printf("bench,Stage,Average per packet,Unit\n");
+    for (unsigned i = 0; i < CONFIG_BENCH_ITERATIONS; i++) {
+        strcpy(addr_str, server_address);
+        start = cycles_now();
+        flow_init(&flow, addr_str, server_port);
+        parse += cycles_now() - start;
+
+        start = cycles_now();
+        gnrc_pktsnip_t *pkt = _alloc_payload(packet_size);
+        if (pkt != NULL) {
+            random_bytes(pkt->data, packet_size);
+            pkt = _build_packet(&server_flow, pkt);
         }
-        printf("neighbor_stats,");
-        printf("%-24s,",
-               gnrc_netif_addr_to_str(entry->l2_addr, entry->l2_addr_len, l2addr_str));
-        if (netstats_nb_isfresh(dev, entry)) {
-            printf("%5u,", (unsigned)entry->freshness);
-        } else {
-            printf("STALE,");
+        build += cycles_now() - start;
+        if (pkt != NULL) {
+            gnrc_pktbuf_release(pkt);
         }
+    }
 
-        printf("%3u%%,", (100 * entry->etx) / NETSTATS_NB_ETX_DIVISOR);
-        printf("%4"PRIu16",%8"PRIu16",", entry->tx_count, entry->rx_count);
-        printf("%4i,", (int8_t) entry->rssi);
-        printf("%u,", entry->lqi);
-        printf("%7"PRIu32, entry->time_tx_avg);
-        printf("\n");
+    start = cycles_now();
+    for (unsigned i = 0; i < CONFIG_BENCH_ITERATIONS; i++) {
+        sample += exponential_distribution(exponential_generator.interval_us);
     }
+    sample_cost = cycles_now() - start;
+
+    printf("bench,flow_init,%" PRIu32 ",%s\n",
+           parse / CONFIG_BENCH_ITERATIONS, CYCLES_UNIT);
+    printf("bench,packet_build,%" PRIu32 ",%s\n",
+           build / CONFIG_BENCH_ITERATIONS, CYCLES_UNIT);
+    printf("bench,exp_sample,%" PRIu32 ",%s\n",
+           sample_cost / CONFIG_BENCH_ITERATIONS, CYCLES_UNIT);
+    /* keep the samples alive */
+    (void)sample;
 }
 
 /* Reads the sensor in an infinite loop. */
@@ -429,37 +1172,504 @@ static void *_run_stats_loop(void *arg)
 {
     (void)arg;
 
-    printf("neighbor_stats,L2 address,fresh,etx,sent,received,rssi (dBm),lqi,avg tx time (µs)\n");
-    printf("rpl_stats,Packet Type,Measurement Type,RX unicast,TX unicast,RX multicast,TX multicast\n");
-    printf("stats,success,layer,rx packets,rx bytes,tx packets,tx multicast packets,tx bytes,tx succeeded,tx errors\n");
-    printf("rpl_status,Type of table,Index of the table,Table status\n");
-    printf("rpl_stats_instance,Instance ID,Interface ID,Mode of Operation,Objective Code Point,Min Hop Rank Increase,Max Rank Increase\n");
-    printf("rpl_stats_dodag,Instance ID,IPv6 Adress,Rank,Role,Prefix Information,Trickle Interval Size Min,Trickle Interval Size Max,Trickle Redundancy Constant,Trickle Counter,Trickle TC\n");
-    printf("rpl_stats_parent,Instance ID,IPv6 Adress,Rank,Lifetime\n");
+    /* with neighbor windows, the loop runs at the neighbor sample rate and
+     * reports once per second of samples */
+    const uint32_t period_ms = CONFIG_STATS_NB_WINDOW
+                               ? CONFIG_STATS_NB_SAMPLE_MS : MS_PER_SEC;
+    uint32_t elapsed_ms = MS_PER_SEC;
+
+    stats_print_headers();
 
     while (1)
     {
-        netif_t *netif = NULL;
-        gnrc_netif_t *gnrc_netif = NULL;
-        while ((netif = netif_iter(netif)))
+        if (!stats_paused)
         {
-            _netif_stats(netif, NETSTATS_LAYER2);
-            _netif_stats(netif, NETSTATS_IPV6);
+            if (CONFIG_STATS_NB_WINDOW) {
+                stats_sample_neighbors();
+            }
+            if (elapsed_ms >= MS_PER_SEC) {
+                stats_report();
+            }
         }
-        while ((gnrc_netif = gnrc_netif_iter(gnrc_netif))) {
-            _print_neighbors(&gnrc_netif->netif);
+        if (elapsed_ms >= MS_PER_SEC) {
+            elapsed_ms -= MS_PER_SEC;
         }
-        rpl_stats();
-        rpl_dodag_show();
-        xtimer_usleep(1 * US_PER_SEC);
+        xtimer_usleep(period_ms * US_PER_MS);
+        elapsed_ms += period_ms;
     }
     return NULL;
 }
 
+/* Copies the settings under gen_lock and prints them after, so that the
+ * generators never wait for the UART. Only called from the shell thread,
+ * which is the only one changing the destination strings. */
+static void _gen_print(void)
+{
+    const char *type = "PERIODIC";
+    const char *dst;
+    uint32_t rate, period, limit, depth;
+    unsigned size, port, reserve;
+    bool paused, stats;
+
+    mutex_lock(&gen_lock);
+    if (exponential_generator.dist == STATS_FLOW_TRACE) {
+        type = "TRACE";
+    }
+    else if (exponential_generator.enabled) {
+        type = periodic_generator.enabled ? "HYBRID" : "EXPONENTIAL";
+    }
+    paused = gen_paused;
+    rate = exponential_generator.param;
+    period = periodic_generator.param;
+    size = exponential_generator.size;
+    dst = exponential_generator.dst.addr_str;
+    port = exponential_generator.dst.port;
+    limit = gen_limit;
+    depth = gen_depth;
+    reserve = gen_reserve;
+    stats = stats_paused;
+    mutex_unlock(&gen_lock);
+
+    printf("info,gen,type,%s%s\n", type, paused ? " (paused)" : "");
+    printf("info,gen,rate,%" PRIu32 ".%06" PRIu32 "\n",
+           rate / PARAM_SCALE, rate % PARAM_SCALE);
+    printf("info,gen,period,%" PRIu32 ".%06" PRIu32 "\n",
+           period / PARAM_SCALE, period % PARAM_SCALE);
+    printf("info,gen,size,%u\n", size);
+    printf("info,gen,dst,%s,%u\n", dst, port);
+    if (limit > 0) {
+        printf("info,gen,limit,%" PRIu32 ".%06" PRIu32 ",%" PRIu32 "\n",
+               limit / PARAM_SCALE, limit % PARAM_SCALE, depth);
+    }
+    else {
+        puts("info,gen,limit,off");
+    }
+    printf("info,gen,reserve,%u\n", reserve);
+    printf("info,gen,stats,%s\n", stats ? "paused" : "running");
+}
+
+/* `gen` keeps driving the two boot generators, see `flow` for the others */
+static int _gen_cmd(int argc, char **argv)
+{
+    uint32_t value;
+    int res = 0;
+
+    if (argc < 2) {
+        _gen_print();
+        return 0;
+    }
+    if ((strcmp(argv[1], "dst") == 0) && (argc >= 3)) {
+        char buf[IPV6_ADDR_MAXLEN+1];
+        flow_t flow;
+
+        if (_dst_parse(&flow, buf, argv[2],
+                       (argc >= 4) ? argv[3] : server_port) < 0) {
+            return 1;
+        }
+        /* both generators switch, or none */
+        mutex_lock(&gen_lock);
+        _gen_set_dst(&exponential_generator, &flow);
+        _gen_set_dst(&periodic_generator, &flow);
+        mutex_unlock(&gen_lock);
+        printf("info,gen,dst,%s,%u\n", buf, flow.port);
+        return 0;
+    }
+
+    mutex_lock(&gen_lock);
+    if ((strcmp(argv[1], "type") == 0) && (argc >= 3)) {
+        res = _gen_set_type(argv[2]);
+    }
+    else if ((strcmp(argv[1], "rate") == 0) && (argc >= 3)) {
+        res = parse_param(argv[2], &value);
+        if ((res == 0) && (value >= PARAM_RATE_MIN) &&
+            (exponential_generator.dist == STATS_FLOW_TRACE)) {
+            /* applies when leaving the TRACE type */
+            exponential_generator.param = value;
+        }
+        else if ((res == 0) && (value >= PARAM_RATE_MIN)) {
+            _gen_set_dist(&exponential_generator, STATS_FLOW_EXPONENTIAL, value);
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if ((strcmp(argv[1], "period") == 0) && (argc >= 3)) {
+        res = parse_param(argv[2], &value);
+        if ((res == 0) && (value > 0)) {
+            _gen_set_dist(&periodic_generator, STATS_FLOW_PERIODIC, value);
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if ((strcmp(argv[1], "size") == 0) && (argc >= 3)) {
+        res = _gen_set_size(&exponential_generator, atoi(argv[2]));
+        if (res == 0) {
+            periodic_generator.size = exponential_generator.size;
+        }
+    }
+    else if ((strcmp(argv[1], "limit") == 0) && (argc >= 3)) {
+        uint32_t depth = (argc >= 4) ? (uint32_t)atoi(argv[3]) : gen_depth;
+
+        if (strcmp(argv[2], "off") == 0) {
+            _gen_set_limit(0, gen_depth);
+        }
+        else if ((parse_param(argv[2], &value) == 0) &&
+                 (value >= PARAM_RATE_MIN) && (depth > 0)) {
+            _gen_set_limit(value, depth);
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if ((strcmp(argv[1], "reserve") == 0) && (argc >= 3)) {
+        int reserve = atoi(argv[2]);
+
+        if (reserve >= 0) {
+            gen_reserve = reserve;
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if (strcmp(argv[1], "pause") == 0) {
+        gen_paused = true;
+    }
+    else if (strcmp(argv[1], "resume") == 0) {
+        gen_paused = false;
+        for (unsigned i = 0; i < ARRAY_SIZE(generators); i++) {
+            _gen_start(&generators[i]);
+        }
+    }
+    else if ((strcmp(argv[1], "stats") == 0) && (argc >= 3)) {
+        if (strcmp(argv[2], "pause") == 0) {
+            stats_paused = true;
+        }
+        else if (strcmp(argv[2], "resume") == 0) {
+            stats_paused = false;
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else {
+        res = -EINVAL;
+    }
+    mutex_unlock(&gen_lock);
+
+    if (res == 0) {
+        _gen_print();
+    }
+
+    if (res == -ENOENT) {
+        puts("error,no trace to replay");
+        return 1;
+    }
+    if (res < 0) {
+        printf("usage: %s [type EXPONENTIAL|PERIODIC|HYBRID|TRACE | rate <packets/s> |"
+               " period <s> | size <bytes> | dst <addr> [port] |"
+               " limit <packets/s> [depth] | limit off | reserve <bytes> |"
+               " pause | resume | stats pause|resume]\n", argv[0]);
+        return 1;
+    }
+    return 0;
+}
+
+/* Like _gen_print(), copies the flow under gen_lock and prints it after */
+static void _flow_print(unsigned idx)
+{
+    const generator_t *gen = &generators[idx];
+    stats_flow_dist_t dist;
+    const char *dst, *state;
+    uint32_t param, on_us, off_us;
+    unsigned size, port;
+
+    mutex_lock(&gen_lock);
+    dist = gen->dist;
+    param = _gen_param(gen);
+    on_us = gen->on_us;
+    off_us = gen->off_us;
+    size = gen->size;
+    dst = gen->dst.addr_str;
+    port = gen->dst.port;
+    state = !gen->enabled ? "stopped" : (gen_paused ? "paused" : "running");
+    mutex_unlock(&gen_lock);
+
+    printf("info,flow,%u,%s,%" PRIu32 ".%06" PRIu32 ",%" PRIu32 ".%06" PRIu32
+           ",%" PRIu32 ".%06" PRIu32 ",%u,%s,%u,%s\n",
+           idx, stats_flow_dist_to_str(dist),
+           param / PARAM_SCALE, param % PARAM_SCALE,
+           on_us / US_PER_SEC, on_us % US_PER_SEC,
+           off_us / US_PER_SEC, off_us % US_PER_SEC,
+           size, dst, port, state);
+}
+
+static void _flow_print_all(void)
+{
+    printf("info,flow,Flow ID,Distribution,Parameter,Burst (s),Silence (s),"
+           "Payload size,Destination,Port,State\n");
+    for (unsigned i = 0; i < ARRAY_SIZE(generators); i++) {
+        _flow_print(i);
+    }
+}
+
+static int _flow_cmd(int argc, char **argv)
+{
+    generator_t *gen;
+    uint32_t value, on = 0, off = 0;
+    unsigned idx;
+    int res = 0;
+
+    if (argc < 2) {
+        _flow_print_all();
+        return 0;
+    }
+    idx = atoi(argv[1]);
+    if ((idx >= ARRAY_SIZE(generators)) || (argc < 3)) {
+        goto usage;
+    }
+    gen = &generators[idx];
+    if ((strcmp(argv[2], "dst") == 0) && (argc >= 4)) {
+        char buf[IPV6_ADDR_MAXLEN+1];
+        flow_t flow;
+
+        if (_dst_parse(&flow, buf, argv[3],
+                       (argc >= 5) ? argv[4] : server_port) < 0) {
+            return 1;
+        }
+        mutex_lock(&gen_lock);
+        _gen_set_dst(gen, &flow);
+        mutex_unlock(&gen_lock);
+        _flow_print(idx);
+        return 0;
+    }
+
+    mutex_lock(&gen_lock);
+    if ((strcmp(argv[2], "exponential") == 0) && (argc >= 4)) {
+        res = parse_param(argv[3], &value);
+        if ((res == 0) && (value >= PARAM_RATE_MIN)) {
+            _gen_set_dist(gen, STATS_FLOW_EXPONENTIAL, value);
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if ((strcmp(argv[2], "periodic") == 0) && (argc >= 4)) {
+        res = parse_param(argv[3], &value);
+        if ((res == 0) && (value > 0)) {
+            _gen_set_dist(gen, STATS_FLOW_PERIODIC, value);
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if ((strcmp(argv[2], "onoff") == 0) && (argc >= 6)) {
+        /* durations in s parse to microseconds */
+        if ((parse_param(argv[3], &value) == 0) &&
+            (value >= PARAM_RATE_MIN) &&
+            (parse_param(argv[4], &on) == 0) && (on > 0) &&
+            (parse_param(argv[5], &off) == 0)) {
+            gen->on_us = on;
+            gen->off_us = off;
+            _gen_set_dist(gen, STATS_FLOW_ONOFF, value);
+        }
+        else {
+            res = -EINVAL;
+        }
+    }
+    else if (strcmp(argv[2], "trace") == 0) {
+        if ((argc >= 4) && (strcmp(argv[3], "once") == 0)) {
+            gen->trace_loop = false;
+        }
+        else if ((argc >= 4) && (strcmp(argv[3], "loop") != 0)) {
+            res = -EINVAL;
+        }
+        else {
+            gen->trace_loop = true;
+        }
+        if (res == 0) {
+            res = _gen_set_dist(gen, STATS_FLOW_TRACE, 0);
+        }
+    }
+    else if ((strcmp(argv[2], "size") == 0) && (argc >= 4)) {
+        res = _gen_set_size(gen, atoi(argv[3]));
+    }
+    else if (strcmp(argv[2], "start") == 0) {
+        gen->enabled = true;
+        _gen_start(gen);
+    }
+    else if (strcmp(argv[2], "stop") == 0) {
+        gen->enabled = false;
+    }
+    else {
+        res = -EINVAL;
+    }
+    mutex_unlock(&gen_lock);
+
+    if (res == 0) {
+        _flow_print(idx);
+    }
+
+    if (res == 0) {
+        return 0;
+    }
+    if (res == -ENOENT) {
+        puts("error,no trace to replay");
+        return 1;
+    }
+usage:
+    printf("usage: %s [<id> exponential <packets/s> | <id> periodic <s> |"
+           " <id> onoff <packets/s> <burst s> <silence s> |"
+           " <id> trace [loop|once] | <id> size <bytes> |"
+           " <id> dst <addr> [port] | <id> start | <id> stop], id < %u\n",
+           argv[0], (unsigned)ARRAY_SIZE(generators));
+    return 1;
+}
+
+/* A running trace flow holds a cursor into the trace, which then must not
+ * change. Must be called with gen_lock held. */
+static bool _trace_busy(void)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(generators); i++) {
+        if ((generators[i].dist == STATS_FLOW_TRACE) && generators[i].queued) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _trace_print(void)
+{
+    const char *source = "none";
+    uint32_t count = 0;
+    uint64_t duration = 0;
+
+    if (trace_len > 0) {
+        source = (trace_data == trace_buf) ? "uploaded" : "built-in";
+        trace_check(trace_data, trace_len, &count, &duration);
+    }
+    printf("info,trace,Source,Bytes,Packets,Duration (s),Upload buffer\n");
+    printf("info,trace,%s,%u,%" PRIu32 ",%" PRIu32 ".%06" PRIu32 ",%u/%u\n",
+           source, (unsigned)trace_len, count,
+           (uint32_t)(duration / US_PER_SEC), (uint32_t)(duration % US_PER_SEC),
+           (unsigned)trace_buf_len, (unsigned)sizeof(trace_buf));
+}
+
+static int _hex_nibble(char c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    c |= 0x20;
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Appends hex encoded bytes to the upload buffer. Must be called with
+ * gen_lock held. */
+static int _trace_append(const char *hex)
+{
+    size_t len = strlen(hex);
+
+    if (len % 2) {
+        return -EINVAL;
+    }
+    if (len / 2 > sizeof(trace_buf) - trace_buf_len) {
+        return -ENOBUFS;
+    }
+    for (size_t i = 0; i < len; i += 2) {
+        int hi = _hex_nibble(hex[i]);
+        int lo = _hex_nibble(hex[i + 1]);
+
+        if ((hi < 0) || (lo < 0)) {
+            return -EINVAL;
+        }
+        trace_buf[trace_buf_len + i / 2] = (hi << 4) | lo;
+    }
+    trace_buf_len += len / 2;
+    return 0;
+}
+
+/* Uploads a trace in chunks: `trace clear`, `trace add <hex>`..., then
+ * `trace done` checks it and replays it from then on.
+ * tools/trace_tool.py prints these lines. */
+static int _trace_cmd(int argc, char **argv)
+{
+    int res = 0;
+
+    mutex_lock(&gen_lock);
+    if (argc < 2) {
+        _trace_print();
+    }
+    else if (strcmp(argv[1], "clear") == 0) {
+        if (_trace_busy()) {
+            res = -EBUSY;
+        }
+        else {
+            trace_buf_len = 0;
+            _trace_use_builtin();
+        }
+    }
+    else if ((strcmp(argv[1], "add") == 0) && (argc >= 3)) {
+        /* the buffer is replayed until the next `trace clear` */
+        res = (trace_data == trace_buf) ? -EBUSY : _trace_append(argv[2]);
+    }
+    else if (strcmp(argv[1], "done") == 0) {
+        if (_trace_busy()) {
+            res = -EBUSY;
+        }
+        else if (trace_check(trace_buf, trace_buf_len, NULL, NULL) < 0) {
+            res = -EINVAL;
+        }
+        else {
+            trace_data = trace_buf;
+            trace_len = trace_buf_len;
+            _trace_print();
+        }
+    }
+    else {
+        res = -ENOTSUP;
+    }
+    mutex_unlock(&gen_lock);
+
+    switch (res) {
+    case 0:
+        return 0;
+    case -EBUSY:
+        puts("error,trace in use, stop the trace flows or clear it first");
+        break;
+    case -ENOBUFS:
+        puts("error,trace upload buffer full");
+        break;
+    case -EINVAL:
+        puts("error,invalid trace");
+        break;
+    default:
+        printf("usage: %s [clear | add <hex> | done]\n", argv[0]);
+        break;
+    }
+    return 1;
+}
+
+static const shell_command_t shell_commands[] = {
+    { "gen", "show or change the traffic generators", _gen_cmd },
+    { "flow", "show or change the traffic flows", _flow_cmd },
+    { "trace", "show or upload the replayed trace", _trace_cmd },
+    { "bufstats", "show the packet buffer and message queue occupancy",
+      bufstats_cmd },
+    { NULL, NULL, NULL }
+};
+
 extern int _gnrc_netif_config(int argc, char **argv);
 
 int main(void)
 {
+    /* below main, the generators and the stats never wait for the UART */
+    evlog_init(evlog_thread_stack, sizeof(evlog_thread_stack),
+               THREAD_PRIORITY_MAIN + 1);
+
     puts("info,message");
     printf("info,wait for the IPV6 address of the server (max len: %d)\n", IPV6_ADDR_MAXLEN);
     readline(server_address, IPV6_ADDR_MAXLEN);
@@ -467,19 +1677,81 @@ int main(void)
     readline(exp_parameter_str, EXP_PARAMETER_MAXLEN);
     readline(period_parameter_str, PERIOD_PARAMETER_MAXLEN);
     readline(packet_size_str, PACKET_SIZE_MAXLEN);
-    sscanf(exp_parameter_str, "%f", &exp_parameter);
-    sscanf(period_parameter_str, "%f", &period_parameter);
+    /* same rules as `gen rate`, `gen period` and `gen size` */
+    if ((parse_param(exp_parameter_str, &exp_parameter) < 0) ||
+        (exp_parameter < PARAM_RATE_MIN)) {
+        puts("error,wrong exponential parameter, using the default");
+        exp_parameter = EXP_PARAMETER_DEFAULT;
+    }
+    if ((parse_param(period_parameter_str, &period_parameter) < 0) ||
+        (period_parameter == 0)) {
+        puts("error,wrong periodic parameter, using the default");
+        period_parameter = PERIOD_PARAMETER_DEFAULT;
+    }
     packet_size = atoi(packet_size_str);
-    xtimer_sleep(20);
+    if ((packet_size < 0) || (packet_size > (int)PACKET_SIZE_MAX)) {
+        printf("error,wrong packet size, using %u\n", (unsigned)PACKET_SIZE_MAX);
+        packet_size = (packet_size < 0) ? 0 : PACKET_SIZE_MAX;
+    }
     printf("info,The server address is '%s'\n", server_address);
     printf("info,The server port is '%s'\n", server_port);
     printf("info,Generation type is '%s'\n", generation_type);
-    printf("info,Exponential parameter is '%f'\n", exp_parameter);
-    printf("info,Periodic parameter is '%f'\n", period_parameter);
+    printf("info,Exponential parameter is '%" PRIu32 ".%06" PRIu32 "'\n",
+           exp_parameter / PARAM_SCALE, exp_parameter % PARAM_SCALE);
+    printf("info,Periodic parameter is '%" PRIu32 ".%06" PRIu32 "'\n",
+           period_parameter / PARAM_SCALE, period_parameter % PARAM_SCALE);
     printf("info,Packet size is '%d'\n", packet_size);
-    puts("info,wait 10 sec before the network is ready to initialize the sensors");
-    xtimer_sleep(10);
+
+    if (flow_init(&server_flow, server_address, server_port) < 0) {
+        printf("info,Wrong destination for the generated traffic.\n");
+        exit(0);
+    }
+
+    printf("info,wait for the network to be ready (max %u sec)\n",
+           CONFIG_READY_TIMEOUT_SEC);
+    ready_times_t ready;
+    int res = ready_wait(server_flow.netif,
+                         IS_ACTIVE(CONFIG_READY_PROBE) ? &server_flow.addr : NULL,
+                         &ready);
+    if (res < 0) {
+        puts("error,network not ready before the timeout, starting anyway");
+    }
+    /* READY_NOT_REACHED is printed as -1 */
+    printf("ready,Global address (ms),DODAG parent (ms),Server probe (ms),Timed out\n");
+    printf("ready,%" PRId32 ",%" PRId32 ",%" PRId32 ",%d\n",
+           (int32_t)ready.addr_ms, (int32_t)ready.dodag_ms,
+           (int32_t)ready.probe_ms, res < 0);
     _gnrc_netif_config(0, NULL);
+    if (IS_ACTIVE(CONFIG_PAYLOAD_HEADER)) {
+        node_id = _get_node_id();
+        printf("info,Payload header enabled, node id is '%u'\n", (unsigned)node_id);
+        if (packet_size < (int)PAYLOAD_HDR_LEN) {
+            printf("error,packet size below the payload header, using %u\n",
+                   PAYLOAD_HDR_LEN);
+            packet_size = PAYLOAD_HDR_LEN;
+        }
+    }
+    if (IS_ACTIVE(CONFIG_AGGREGATE)) {
+        printf("info,Aggregation enabled, %u bytes per datagram, %u ms hold\n",
+               (unsigned)CONFIG_AGGREGATE_BUDGET,
+               (unsigned)CONFIG_AGGREGATE_HOLD_MS);
+    }
+    if (IS_ACTIVE(CONFIG_PATH_LATENCY)) {
+        gnrc_netif_t *netif = server_flow.netif ? server_flow.netif
+                                                : gnrc_netif_iter(NULL);
+
+        if (netif != NULL) {
+            pathlat_init(netif, node_id);
+            stats_set_path_source(pathlat_get);
+            printf("info,Packet path latency measured on interface %d\n",
+                   netif->pid);
+        }
+    }
+    _gen_init();
+    stats_set_flow_source(_gen_stats);
+    if (IS_ACTIVE(CONFIG_BENCH)) {
+        _bench();
+    }
 
     puts("info,Starting the stats thread");
     thread_create(stats_thread_stack, sizeof(stats_thread_stack),
@@ -489,29 +1761,32 @@ int main(void)
 
     puts("info,Starting the sensors thread");
     printf("udp,payload size,destination address,destination port,payload\n");
-    
-    if (strncmp(generation_type, "EXPONENTIAL", strlen(generation_type)) == 0) {
-        puts("info,Starting the exponential sensor thread");
-        thread_create(exponential_sensors_thread_stack, sizeof(exponential_sensors_thread_stack),
-                    THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
-                    _run_exponential_sensor_loop, NULL, "exponential_read_sensors_thread");
-    } else if (strncmp(generation_type, "PERIODIC", strlen(generation_type)) == 0) {
-        puts("info,Starting the periodic sensor thread");
-        thread_create(periodic_sensors_thread_stack, sizeof(periodic_sensors_thread_stack),
-                    THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
-                    _run_periodic_sensor_loop, NULL, "periodic_read_sensors_thread");
-    } else if (strncmp(generation_type, "HYBRID", strlen(generation_type)) == 0) {
-        puts("info,Starting both sensor threads (exponential, periodic)");
-        thread_create(exponential_sensors_thread_stack, sizeof(exponential_sensors_thread_stack),
-            THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
-            _run_exponential_sensor_loop, NULL, "exponential_read_sensors_thread");
-        thread_create(periodic_sensors_thread_stack, sizeof(periodic_sensors_thread_stack),
-            THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
-            _run_periodic_sensor_loop, NULL, "periodic_read_sensors_thread");
-    } else {
+
+    mutex_lock(&gen_lock);
+    res = _gen_set_type(generation_type);
+    mutex_unlock(&gen_lock);
+    if (res == -ENOENT) {
+        /* nothing is sent until a trace is uploaded, see the trace command */
+        puts("error,no trace to replay, upload one then run 'gen type TRACE'");
+    } else if (res < 0) {
         printf("info,Wrong type of packet generation.\n");
         exit(0);
+    } else if (exponential_generator.dist == STATS_FLOW_TRACE) {
+        puts("info,Starting the trace replay");
+    } else if (!periodic_generator.enabled) {
+        puts("info,Starting the exponential sensor");
+    } else if (!exponential_generator.enabled) {
+        puts("info,Starting the periodic sensor");
+    } else {
+        puts("info,Starting both sensors (exponential, periodic)");
     }
+    txsched_start(sensors_thread_stack, sizeof(sensors_thread_stack),
+                  THREAD_PRIORITY_MAIN - 1);
+
+    /* control channel, see the `gen`, `flow` and `trace` commands */
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
     /* should be never reached */
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,256 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Latency of the generated packets along the packet path
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "irq.h"
+#include "kernel_defines.h"
+#include "xtimer.h"
+
+#include "net/gnrc.h"
+#include "net/netdev.h"
+#include "net/netopt.h"
+
+#include "payload_hdr.h"
+#include "pathlat.h"
+
+/* A packet handed to UDP, until the netif thread hands it to the driver */
+typedef struct {
+    uint32_t seq;
+    uint32_t last_us;       /* time of the last boundary */
+    uint8_t gen;
+    uint8_t stage;          /* stats_path_stage_t ending at the next one */
+    bool used;
+} _inflight_t;
+
+/* The frame being transmitted, only touched by the netif thread */
+typedef struct {
+    uint32_t created_us;    /* time in the payload header */
+    uint32_t last_us;       /* time of the last boundary */
+    bool active;            /* the frame is one of ours */
+} _tx_t;
+
+static stats_rec_path_t _hist[STATS_PATH_NUMOF];
+static _inflight_t _inflight[CONFIG_PATHLAT_INFLIGHT];
+static unsigned _inflight_next;
+static _tx_t _tx;
+static uint16_t _node_id;
+
+/* the wrapped operations of the interface */
+static gnrc_netif_ops_t _ops;
+static int (*_send)(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+static netdev_event_cb_t _event_cb;
+
+static void _add(stats_path_stage_t stage, uint32_t us)
+{
+    stats_rec_path_t *hist = &_hist[stage];
+    unsigned state = irq_disable();
+
+    hist->count++;
+    hist->buckets[stats_path_bucket(us)]++;
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+    irq_restore(state);
+}
+
+/* Reads the header of the first sample of a payload of this node */
+static bool _parse(const void *payload, size_t len, payload_hdr_t *hdr)
+{
+    payload_iter_t it;
+
+    payload_iter_init(&it, payload, len);
+    return (payload_iter_next(&it, hdr) == 0) && (hdr->node_id == _node_id);
+}
+
+void pathlat_dispatch(const void *payload, size_t len)
+{
+    uint32_t now = xtimer_now_usec();
+    payload_hdr_t hdr;
+    unsigned state;
+
+    if (!_parse(payload, len, &hdr)) {
+        return;
+    }
+    _add(STATS_PATH_GEN, now - hdr.time);
+    state = irq_disable();
+    _inflight[_inflight_next] = (_inflight_t){
+        .seq = hdr.seq,
+        .last_us = now,
+        .gen = hdr.gen,
+        .stage = STATS_PATH_UDP,
+        .used = true,
+    };
+    _inflight_next = (_inflight_next + 1) % CONFIG_PATHLAT_INFLIGHT;
+    irq_restore(state);
+}
+
+/* Ends the current stage of a packet in flight at a boundary. next is the
+ * stage starting there, STATS_PATH_NUMOF at the driver, where the packet
+ * leaves the in-flight table. */
+static void _boundary(const payload_hdr_t *hdr, uint32_t now,
+                      stats_path_stage_t next)
+{
+    stats_path_stage_t stage = STATS_PATH_NUMOF;
+    uint32_t last_us = 0;
+    unsigned state = irq_disable();
+
+    for (unsigned i = 0; i < CONFIG_PATHLAT_INFLIGHT; i++) {
+        _inflight_t *entry = &_inflight[i];
+
+        if (entry->used && (entry->seq == hdr->seq) &&
+            (entry->gen == hdr->gen)) {
+            stage = entry->stage;
+            last_us = entry->last_us;
+            entry->stage = next;
+            entry->last_us = now;
+            entry->used = (next != STATS_PATH_NUMOF);
+            break;
+        }
+    }
+    irq_restore(state);
+    if (stage != STATS_PATH_NUMOF) {
+        _add(stage, now - last_us);
+    }
+}
+
+/* Reads the payload header of a packet of this node on its way down, the
+ * UDP payload being the last snip behind the headers */
+static bool _pkt_parse(gnrc_pktsnip_t *pkt, payload_hdr_t *hdr)
+{
+    gnrc_pktsnip_t *payload = pkt;
+
+    while (payload->next != NULL) {
+        payload = payload->next;
+    }
+    return (payload != pkt) && (payload->type == GNRC_NETTYPE_UNDEF) &&
+           _parse(payload->data, payload->size, hdr);
+}
+
+#if IS_ACTIVE(CONFIG_PATH_LATENCY)
+/* the real function, see the --wrap flag in the Makefile */
+int __real_gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
+                                uint16_t cmd, gnrc_pktsnip_t *pkt);
+
+/* UDP hands its packets to IPv6, and IPv6 to 6LoWPAN, through here */
+int __wrap_gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
+                                uint16_t cmd, gnrc_pktsnip_t *pkt)
+{
+    stats_path_stage_t next = STATS_PATH_NUMOF;
+    payload_hdr_t hdr;
+
+    if (cmd == GNRC_NETAPI_MSG_TYPE_SND) {
+        if (type == GNRC_NETTYPE_IPV6) {
+            next = STATS_PATH_IPV6;
+        }
+#ifdef MODULE_GNRC_SIXLOWPAN
+        else if (type == GNRC_NETTYPE_SIXLOWPAN) {
+            next = STATS_PATH_SIXLOWPAN;
+        }
+#endif
+    }
+    /* before the dispatch, the next thread may run right away */
+    if ((next != STATS_PATH_NUMOF) && _pkt_parse(pkt, &hdr)) {
+        _boundary(&hdr, xtimer_now_usec(), next);
+    }
+    return __real_gnrc_netapi_dispatch(type, demux_ctx, cmd, pkt);
+}
+#endif
+
+static int _send_wrapper(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    uint32_t now = xtimer_now_usec();
+    payload_hdr_t hdr;
+    int res;
+
+    /* 6LoWPAN replaces the headers but keeps the UDP payload as the last
+     * snip, unless it fragments the packet */
+    _tx.active = _pkt_parse(pkt, &hdr);
+    if (_tx.active) {
+        _boundary(&hdr, now, STATS_PATH_NUMOF);
+        _tx.created_us = hdr.time;
+        _tx.last_us = now;
+    }
+    /* drivers may signal the start of the transmission from in here */
+    res = _send(netif, pkt);
+    if (res < 0) {
+        _tx.active = false;
+    }
+    return res;
+}
+
+static void _event_wrapper(netdev_t *dev, netdev_event_t event)
+{
+    uint32_t now = xtimer_now_usec();
+
+    if (_tx.active) {
+        switch (event) {
+        case NETDEV_EVENT_TX_STARTED:
+            _add(STATS_PATH_TX_START, now - _tx.last_us);
+            _tx.last_us = now;
+            break;
+        case NETDEV_EVENT_TX_COMPLETE:
+        case NETDEV_EVENT_TX_COMPLETE_DATA_PENDING:
+        case NETDEV_EVENT_TX_NOACK:
+        case NETDEV_EVENT_TX_MEDIUM_BUSY:
+            _add(STATS_PATH_TX_DONE, now - _tx.last_us);
+            _add(STATS_PATH_TOTAL, now - _tx.created_us);
+            _tx.active = false;
+            break;
+        default:
+            break;
+        }
+    }
+    _event_cb(dev, event);
+}
+
+void pathlat_init(gnrc_netif_t *netif, uint16_t node_id)
+{
+    netopt_enable_t enable = NETOPT_ENABLE;
+    unsigned state;
+
+    _node_id = node_id;
+    for (unsigned i = 0; i < STATS_PATH_NUMOF; i++) {
+        _hist[i].stage = i;
+    }
+    /* the events are off by default, drivers without them ignore this */
+    gnrc_netapi_set(netif->pid, NETOPT_TX_START_IRQ, 0, &enable, sizeof(enable));
+    gnrc_netapi_set(netif->pid, NETOPT_TX_END_IRQ, 0, &enable, sizeof(enable));
+
+    /* the operations are shared by all the interfaces of a type, wrap a
+     * copy for this one */
+    _ops = *netif->ops;
+    _send = _ops.send;
+    _ops.send = _send_wrapper;
+    state = irq_disable();
+    netif->ops = &_ops;
+    _event_cb = netif->dev->event_callback;
+    netif->dev->event_callback = _event_wrapper;
+    irq_restore(state);
+}
+
+bool pathlat_get(unsigned stage, stats_rec_path_t *rec)
+{
+    unsigned state;
+
+    if (stage >= STATS_PATH_NUMOF) {
+        return false;
+    }
+    state = irq_disable();
+    *rec = _hist[stage];
+    irq_restore(state);
+    return true;
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Latency of the generated packets along the packet path
+ *
+ * Timestamps the packets of this node at the stage boundaries the
+ * application can observe without changes to GNRC, and keeps one latency
+ * histogram per stage (stats_path_stage_t):
+ *
+ * - the generator, right before it hands the packet to the UDP thread
+ * - the UDP thread handing the packet to IPv6, and IPv6 handing it to
+ *   6LoWPAN, by wrapping gnrc_netapi_dispatch() at link time
+ * - the interface, when the netif thread hands the frame to the driver, by
+ *   wrapping the send operation of the interface
+ * - the driver, at the start and at the end of the transmission, from the
+ *   NETDEV_EVENT_TX_STARTED and NETDEV_EVENT_TX_COMPLETE (or NOACK,
+ *   MEDIUM_BUSY) events, by wrapping the event callback of the device
+ *
+ * Packets are recognized by their payload header (node id, generator,
+ * sequence number, creation time), so the application needs
+ * CONFIG_PAYLOAD_HEADER. For an aggregate, the first sample counts, so the
+ * gen stage includes the hold time. Fragmented packets and the packets
+ * forwarded for other nodes are not measured. Stages a driver does not
+ * signal are skipped: without TX_STARTED, tx_done starts at the driver.
+ *
+ * A stage runs from a hand-over to the next one, so it includes the wait
+ * in the message queue of its thread. The 6LoWPAN thread hands the frame
+ * to the netif thread with gnrc_netapi_send(), which is a static inline
+ * function and cannot be wrapped: the sixlowpan stage includes the netif
+ * queue. Without 6LoWPAN, the ipv6 stage ends at the driver.
+ *
+ * @}
+ */
+
+#ifndef PATHLAT_H
+#define PATHLAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/gnrc/netif.h"
+
+#include "stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Packets handed to UDP whose times are kept until the driver
+ *
+ * Bounds the packets of this node in flight between the generator and the
+ * driver, older ones are not measured past the gen stage.
+ */
+#ifndef CONFIG_PATHLAT_INFLIGHT
+#define CONFIG_PATHLAT_INFLIGHT     (16U)
+#endif
+
+/**
+ * @brief   Start measuring the packets of this node on an interface
+ *
+ * @param[in] netif     interface to instrument, its send operation and
+ *                      device event callback are wrapped
+ * @param[in] node_id   node id of the payload headers of this node
+ */
+void pathlat_init(gnrc_netif_t *netif, uint16_t node_id);
+
+/**
+ * @brief   Record that a payload is about to be handed to the UDP thread
+ *
+ * Call right before the dispatch: the stack threads have a higher priority
+ * and may send the frame before the dispatch returns.
+ *
+ * @param[in] payload   UDP payload, starting with a payload header or an
+ *                      aggregate of samples
+ * @param[in] len       length of @p payload
+ */
+void pathlat_dispatch(const void *payload, size_t len);
+
+/**
+ * @brief   Read the histogram of a stage, a stats_path_get_t
+ */
+bool pathlat_get(unsigned stage, stats_rec_path_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PATHLAT_H */
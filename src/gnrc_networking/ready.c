@@ -0,0 +1,208 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Waits until the node can reach the server
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "net/gnrc.h"
+#include "net/gnrc/icmpv6.h"
+#include "net/gnrc/icmpv6/echo.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/rpl.h"
+#include "net/icmpv6.h"
+
+#include "ready.h"
+
+#define READY_MSG_QUEUE_SIZE    (4)
+#define READY_PROBE_ID          (0x5359)
+
+static bool _has_global_addr(gnrc_netif_t *netif)
+{
+    bool found = false;
+
+    gnrc_netif_acquire(netif);
+    for (unsigned i = 0; i < CONFIG_GNRC_NETIF_IPV6_ADDRS_NUMOF; i++) {
+        uint8_t state = netif->ipv6.addrs_flags[i] &
+                        GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_MASK;
+
+        /* tentative addresses are not usable yet */
+        if ((state == GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID) &&
+            !ipv6_addr_is_link_local(&netif->ipv6.addrs[i])) {
+            found = true;
+            break;
+        }
+    }
+    gnrc_netif_release(netif);
+    return found;
+}
+
+static bool _addr_ready(gnrc_netif_t *netif)
+{
+    if (netif != NULL) {
+        return _has_global_addr(netif);
+    }
+    while ((netif = gnrc_netif_iter(netif))) {
+        if (_has_global_addr(netif)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _dodag_ready(void)
+{
+    for (unsigned i = 0; i < GNRC_RPL_INSTANCES_NUMOF; i++) {
+        gnrc_rpl_instance_t *inst = &gnrc_rpl_instances[i];
+
+        if (inst->state == 0) {
+            continue;
+        }
+        /* the preferred parent is the head of the parent list */
+        if ((inst->dodag.parents != NULL) ||
+            (inst->dodag.node_status == GNRC_RPL_ROOT_NODE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Sends one echo request to server and waits for the reply */
+static bool _probe(gnrc_netif_t *netif, const ipv6_addr_t *server, uint16_t seq)
+{
+    gnrc_pktsnip_t *pkt, *ip;
+    msg_t msg;
+
+    pkt = gnrc_icmpv6_echo_build(ICMPV6_ECHO_REQ, READY_PROBE_ID, seq, NULL, 0);
+    if (pkt == NULL) {
+        return false;
+    }
+    ip = gnrc_ipv6_hdr_build(pkt, NULL, server);
+    if (ip == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return false;
+    }
+    if (netif != NULL) {
+        gnrc_pktsnip_t *netif_hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+
+        if (netif_hdr == NULL) {
+            gnrc_pktbuf_release(ip);
+            return false;
+        }
+        gnrc_netif_hdr_set_netif(netif_hdr->data, netif);
+        ip = gnrc_pkt_prepend(ip, netif_hdr);
+    }
+    if (!gnrc_netapi_dispatch_send(GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL, ip)) {
+        gnrc_pktbuf_release(ip);
+        return false;
+    }
+
+    uint64_t deadline = xtimer_now_usec64() + CONFIG_READY_PROBE_TIMEOUT_US;
+    uint64_t now;
+    while ((now = xtimer_now_usec64()) < deadline) {
+        if (xtimer_msg_receive_timeout64(&msg, deadline - now) < 0) {
+            break;
+        }
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        gnrc_pktsnip_t *reply = msg.content.ptr;
+        gnrc_pktsnip_t *icmpv6 = gnrc_pktsnip_search_type(reply,
+                                                          GNRC_NETTYPE_ICMPV6);
+        bool match = false;
+
+        if ((icmpv6 != NULL) && (icmpv6->size >= sizeof(icmpv6_echo_t))) {
+            icmpv6_echo_t *echo = icmpv6->data;
+
+            /* replies to an earlier, timed out probe count as well */
+            match = (byteorder_ntohs(echo->id) == READY_PROBE_ID);
+        }
+        gnrc_pktbuf_release(reply);
+        if (match) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t _elapsed_ms(uint64_t start)
+{
+    return (xtimer_now_usec64() - start) / US_PER_MS;
+}
+
+int ready_wait(gnrc_netif_t *netif, const ipv6_addr_t *server,
+               ready_times_t *times)
+{
+    static msg_t msg_queue[READY_MSG_QUEUE_SIZE];
+    gnrc_netreg_entry_t echo_reply = GNRC_NETREG_ENTRY_INIT_PID(ICMPV6_ECHO_REP,
+                                                                thread_getpid());
+    uint64_t start = xtimer_now_usec64();
+    uint64_t timeout = (uint64_t)CONFIG_READY_TIMEOUT_SEC * US_PER_SEC;
+    uint16_t seq = 0;
+    int res = -ETIMEDOUT;
+
+    times->addr_ms = READY_NOT_REACHED;
+    times->dodag_ms = READY_NOT_REACHED;
+    times->probe_ms = READY_NOT_REACHED;
+
+    if (server != NULL) {
+        if (!thread_has_msg_queue(thread_get_active())) {
+            msg_init_queue(msg_queue, READY_MSG_QUEUE_SIZE);
+        }
+        gnrc_netreg_register(GNRC_NETTYPE_ICMPV6, &echo_reply);
+    }
+
+    while (xtimer_now_usec64() - start < timeout) {
+        if ((times->addr_ms == READY_NOT_REACHED) && _addr_ready(netif)) {
+            times->addr_ms = _elapsed_ms(start);
+        }
+        if ((times->dodag_ms == READY_NOT_REACHED) && _dodag_ready()) {
+            times->dodag_ms = _elapsed_ms(start);
+        }
+        if ((times->addr_ms != READY_NOT_REACHED) &&
+            (times->dodag_ms != READY_NOT_REACHED)) {
+            if (server == NULL) {
+                res = 0;
+                break;
+            }
+            /* waits up to CONFIG_READY_PROBE_TIMEOUT_US itself */
+            if (_probe(netif, server, seq++)) {
+                times->probe_ms = _elapsed_ms(start);
+                res = 0;
+                break;
+            }
+        }
+        xtimer_usleep(CONFIG_READY_POLL_INTERVAL_US);
+    }
+
+    if (server != NULL) {
+        msg_t msg;
+
+        gnrc_netreg_unregister(GNRC_NETTYPE_ICMPV6, &echo_reply);
+        /* late replies would otherwise stay in the packet buffer */
+        while (msg_try_receive(&msg) == 1) {
+            if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+                gnrc_pktbuf_release(msg.content.ptr);
+            }
+        }
+    }
+    return res;
+}
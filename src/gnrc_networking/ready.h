@@ -0,0 +1,86 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Waits until the node can reach the server
+ *
+ * Replaces fixed startup delays: the node is ready once it has a valid
+ * global IPv6 address, has joined a RPL DODAG with a preferred parent (or
+ * is its root) and, optionally, got an ICMPv6 echo reply from the server.
+ *
+ * @}
+ */
+
+#ifndef READY_H
+#define READY_H
+
+#include <stdint.h>
+
+#include "timex.h"
+#include "net/gnrc/netif.h"
+#include "net/ipv6/addr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Give up waiting after this many seconds
+ */
+#ifndef CONFIG_READY_TIMEOUT_SEC
+#define CONFIG_READY_TIMEOUT_SEC        (30U)
+#endif
+
+/**
+ * @brief   Interval between two checks in microseconds
+ */
+#ifndef CONFIG_READY_POLL_INTERVAL_US
+#define CONFIG_READY_POLL_INTERVAL_US   (100U * US_PER_MS)
+#endif
+
+/**
+ * @brief   Time to wait for an echo reply in microseconds
+ */
+#ifndef CONFIG_READY_PROBE_TIMEOUT_US
+#define CONFIG_READY_PROBE_TIMEOUT_US   (1U * US_PER_SEC)
+#endif
+
+/**
+ * @brief   Value of a step of ready_times_t that was not reached
+ */
+#define READY_NOT_REACHED               (UINT32_MAX)
+
+/**
+ * @brief   Time from the start of ready_wait() to each step, in milliseconds
+ */
+typedef struct {
+    uint32_t addr_ms;       /**< global address valid */
+    uint32_t dodag_ms;      /**< DODAG joined with a preferred parent */
+    uint32_t probe_ms;      /**< echo reply from the server */
+} ready_times_t;
+
+/**
+ * @brief   Block until the node is ready or CONFIG_READY_TIMEOUT_SEC
+ *
+ * @param[in] netif     interface to check, NULL for any
+ * @param[in] server    destination of the probe, NULL for no probe
+ * @param[out] times    time to each step
+ *
+ * @return  0 when ready
+ * @return  -ETIMEDOUT on timeout
+ */
+int ready_wait(gnrc_netif_t *netif, const ipv6_addr_t *server,
+               ready_times_t *times);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* READY_H */
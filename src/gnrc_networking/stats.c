@@ -0,0 +1,1156 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Network statistics reporting for the gnrc_networking firmware
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "checksum/crc16_ccitt.h"
+#include "evlog.h"
+#include "irq.h"
+#include "kernel_defines.h"
+#include "sched.h"
+#include "stdio_base.h"
+#include "thread.h"
+#include "xtimer.h"
+#ifdef MODULE_SCHEDSTATISTICS
+#include "schedstatistics.h"
+#endif
+#ifdef MODULE_BUFSTATS
+#include "bufstats.h"
+#endif
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif.h"
+#include "net/ipv6/addr.h"
+#include "net/netif.h"
+#include "net/netstats.h"
+#include "net/netstats/neighbor.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/structs.h"
+#include "net/gnrc/rpl/dodag.h"
+
+#include "stats.h"
+
+#define STATS_FRAME_MAXLEN  (3 + UINT8_MAX + 2)
+
+#if CONFIG_STATS_KEYFRAME_INTERVAL == 0
+#error "CONFIG_STATS_KEYFRAME_INTERVAL must be at least 1"
+#endif
+
+/* one delta cache slot per record that can be part of a snapshot */
+#define STATS_CACHE_SIZE    (GNRC_NETIF_NUMOF * (2 + NETSTATS_NB_SIZE) + \
+                             STATS_RPL_NUMOF + 3 * GNRC_RPL_INSTANCES_NUMOF + \
+                             2 * GNRC_RPL_PARENTS_NUMOF + \
+                             CONFIG_STATS_FLOWS_NUMOF + \
+                             (CONFIG_STATS_THREADS ? MAXTHREADS : 0) + \
+                             STATS_PATH_NUMOF + \
+                             (IS_USED(MODULE_BUFSTATS) ? 1 + MAXTHREADS : 0))
+
+typedef struct {
+    uint32_t hash;          /* hash of the last reported record */
+    uint16_t key;           /* table slot of the record */
+    uint8_t type;           /* record type, 0 if the slot is unused */
+    uint8_t seen;           /* record was part of the current snapshot */
+} _cache_entry_t;
+
+typedef struct {
+    ipv6_addr_t dodag_id;
+    ipv6_addr_t parent;
+    uint16_t rank;
+    uint8_t instance_id;
+} _rpl_last_t;
+
+/* running sums of one metric, relative to the first sample of the window so
+ * that the sums stay small and the variance exact */
+typedef struct {
+    int32_t first;
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint64_t sum_sq;
+} _nb_acc_t;
+
+typedef struct {
+    uint8_t l2_addr[8];
+    uint8_t l2_addr_len;    /* 0 if the slot is not tracked */
+    uint16_t samples;
+    uint16_t tx_count;
+    uint16_t rx_count;
+    _nb_acc_t acc[STATS_NB_METRIC_NUMOF];
+} _nb_window_t;
+
+typedef struct {
+    uint64_t runtime;       /* schedstatistics runtime at the last report */
+    uint64_t runtime_delta; /* runtime since the report before */
+    unsigned schedules;     /* schedstatistics count at the last report */
+    unsigned schedules_delta;
+} _thread_last_t;
+
+static _cache_entry_t _cache[STATS_CACHE_SIZE];
+/* identities of the records that their cache key does not give, for the
+ * removal records */
+static uint8_t _nb_ids[GNRC_NETIF_NUMOF * NETSTATS_NB_SIZE]
+                      [offsetof(stats_rec_neighbor_t, fresh)];
+static uint8_t _parent_ids[GNRC_RPL_PARENTS_NUMOF]
+                          [offsetof(stats_rec_rpl_parent_t, rank)];
+static uint8_t _instance_ids[GNRC_RPL_INSTANCES_NUMOF][1];
+static _rpl_last_t _rpl_last[GNRC_RPL_INSTANCES_NUMOF];
+static uint32_t _snapshot_seq;
+static stats_flow_get_t _flow_get;
+static stats_path_get_t _path_get;
+#ifdef MODULE_SCHEDSTATISTICS
+static _thread_last_t _thread_last[MAXTHREADS];
+#endif
+#if CONFIG_STATS_NB_WINDOW
+static _nb_window_t _nb_windows[GNRC_NETIF_NUMOF][NETSTATS_NB_SIZE];
+#endif
+static bool _keyframe;
+
+static const char *_netstats_module_to_str(uint8_t module)
+{
+    switch (module)
+    {
+    case NETSTATS_LAYER2:
+        return "Layer 2";
+    case NETSTATS_IPV6:
+        return "IPv6";
+    case NETSTATS_ALL:
+        return "all";
+    default:
+        return "Unknown";
+    }
+}
+
+static const char *_rpl_msg_to_str(uint8_t msg)
+{
+    static const char *names[] = { "DIO", "DIS", "DAO", "DAO-ACK" };
+
+    return (msg < STATS_RPL_NUMOF) ? names[msg] : "Unknown";
+}
+
+const char *stats_flow_dist_to_str(uint8_t dist)
+{
+    static const char *names[] = { "exponential", "periodic", "onoff", "trace" };
+
+    return (dist < STATS_FLOW_NUMOF) ? names[dist] : "Unknown";
+}
+
+const char *stats_path_stage_to_str(uint8_t stage)
+{
+    static const char *names[] = { "gen", "udp", "ipv6", "sixlowpan",
+                                   "tx_start", "tx_done", "total" };
+
+    return (stage < STATS_PATH_NUMOF) ? names[stage] : "Unknown";
+}
+
+static void _csv_netif(const stats_rec_netif_t *rec)
+{
+    if (!rec->success) {
+        printf("stats,0,-1,-1,-1,-1,-1,-1,-1,-1\n");
+        return;
+    }
+    printf("stats,1,%s,%u,%u,%u,%u,%u,%u,%u\n",
+           _netstats_module_to_str(rec->module),
+           (unsigned)rec->rx_count,
+           (unsigned)rec->rx_bytes,
+           (unsigned)rec->tx_count,
+           (unsigned)rec->tx_mcast_count,
+           (unsigned)rec->tx_bytes,
+           (unsigned)rec->tx_success,
+           (unsigned)rec->tx_failed);
+}
+
+static void _csv_neighbor(const stats_rec_neighbor_t *rec)
+{
+    char l2addr_str[3 * L2UTIL_ADDR_MAX_LEN];
+
+    printf("neighbor_stats,");
+    printf("%-24s,",
+           gnrc_netif_addr_to_str(rec->l2_addr, rec->l2_addr_len, l2addr_str));
+    if (rec->fresh) {
+        printf("%5u,", (unsigned)rec->freshness);
+    } else {
+        printf("STALE,");
+    }
+
+    printf("%3u%%,", (unsigned)rec->etx_percent);
+    printf("%4"PRIu16",%8"PRIu16",", rec->tx_count, rec->rx_count);
+    printf("%4i,", rec->rssi);
+    printf("%u,", rec->lqi);
+    printf("%7"PRIu32, rec->time_tx_avg);
+    printf("\n");
+}
+
+static void _csv_centi(int32_t centi)
+{
+    uint32_t abs = (centi < 0) ? -(uint32_t)centi : (uint32_t)centi;
+
+    printf(",%s%" PRIu32 ".%02u", (centi < 0) ? "-" : "", abs / 100,
+           (unsigned)(abs % 100));
+}
+
+static void _csv_nb_window(const stats_rec_nb_window_t *rec)
+{
+    char l2addr_str[3 * L2UTIL_ADDR_MAX_LEN];
+
+    printf("neighbor_window,%s,%u,%u,%u",
+           gnrc_netif_addr_to_str(rec->l2_addr, rec->l2_addr_len, l2addr_str),
+           rec->samples, rec->tx_count, rec->rx_count);
+    for (unsigned i = 0; i < STATS_NB_METRIC_NUMOF; i++) {
+        const stats_nb_dist_t *dist = &rec->dist[i];
+
+        printf(",%" PRIi32 ",%" PRIi32, dist->min, dist->max);
+        _csv_centi(dist->mean_centi);
+        printf(",%" PRIu32 ".%02u", dist->var_centi / 100,
+               (unsigned)(dist->var_centi % 100));
+    }
+    printf("\n");
+}
+
+static void _csv_rpl(const stats_rec_rpl_t *rec)
+{
+    const char *name = _rpl_msg_to_str(rec->msg);
+
+    printf("rpl_stats,%s,packets,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
+           name, rec->rx_ucast_count, rec->tx_ucast_count,
+           rec->rx_mcast_count, rec->tx_mcast_count);
+    printf("rpl_stats,%s,bytes,%10" PRIu32 ",%-10" PRIu32 ",%10" PRIu32 ",%-10" PRIu32 "\n",
+           name, rec->rx_ucast_bytes, rec->tx_ucast_bytes,
+           rec->rx_mcast_bytes, rec->tx_mcast_bytes);
+}
+
+static void _csv_rpl_status(const stats_rec_rpl_status_t *rec)
+{
+    printf("rpl_status,%s,%d,%d\n", rec->table ? "parent" : "instance",
+           rec->index, rec->state);
+}
+
+static void _csv_rpl_instance(const stats_rec_rpl_instance_t *rec)
+{
+    printf("rpl_stats_instance,%d,%d,%d,%d,%d,%d\n",
+           rec->id, rec->iface, rec->mop, rec->ocp,
+           rec->min_hop_rank_inc, rec->max_rank_inc);
+}
+
+static void _csv_rpl_dodag(const stats_rec_rpl_dodag_t *rec)
+{
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+    ipv6_addr_t dodag_id;
+
+    memcpy(&dodag_id, rec->dodag_id, sizeof(dodag_id));
+
+    printf("rpl_stats_dodag,%d,%s,%d,%s,%s,%d,%d,%d,%d,%" PRIu32 "\n", rec->instance_id,
+           ipv6_addr_to_str(addr_str, &dodag_id, sizeof(addr_str)),
+           rec->rank, (rec->leaf ? "Leaf" : "Router"),
+           (rec->prefix_info ? "on" : "off"),
+           (1 << rec->dio_min), rec->dio_interval_doubl, rec->trickle_k,
+           rec->trickle_c, rec->trickle_tc);
+}
+
+static void _csv_rpl_event_addr(const uint8_t *bytes)
+{
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+    ipv6_addr_t addr;
+
+    memcpy(&addr, bytes, sizeof(addr));
+    printf("%s", ipv6_addr_is_unspecified(&addr)
+                 ? "-" : ipv6_addr_to_str(addr_str, &addr, sizeof(addr_str)));
+}
+
+static void _csv_rpl_event(const stats_rec_rpl_event_t *rec)
+{
+    static const char *names[] = { "dodag", "parent", "rank" };
+
+    printf("rpl_event,%d,%s,", rec->instance_id,
+           (rec->event <= STATS_RPL_EVENT_RANK) ? names[rec->event] : "Unknown");
+    if (rec->event == STATS_RPL_EVENT_RANK) {
+        printf("%d,%d\n", rec->old_rank, rec->new_rank);
+        return;
+    }
+    _csv_rpl_event_addr(rec->old_addr);
+    printf(",");
+    _csv_rpl_event_addr(rec->new_addr);
+    printf("\n");
+}
+
+static void _csv_snapshot(const stats_rec_snapshot_t *rec)
+{
+    printf("stats_snapshot,%" PRIu32 ",%d\n", rec->seq, rec->keyframe);
+}
+
+static void _csv_flow(const stats_rec_flow_t *rec)
+{
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+    ipv6_addr_t addr;
+
+    memcpy(&addr, rec->addr, sizeof(addr));
+
+    printf("flow_stats,%d,%s,%" PRIu32 ".%06" PRIu32 ",%d,%s,%d,%d,"
+           "%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n",
+           rec->id, stats_flow_dist_to_str(rec->dist),
+           rec->param / 1000000UL, rec->param % 1000000UL, rec->size,
+           ipv6_addr_to_str(addr_str, &addr, sizeof(addr_str)), rec->port,
+           rec->active, rec->sent, rec->bytes, rec->dropped_stack,
+           rec->offered, rec->dropped_src);
+}
+
+static void _csv_thread(const stats_rec_thread_t *rec)
+{
+    printf("thread_stats,%d,%.*s,%d,%u.%u,%" PRIu32 ",%u,%u\n",
+           rec->pid, (int)strnlen(rec->name, sizeof(rec->name)), rec->name,
+           rec->priority, rec->cpu_permille / 10, rec->cpu_permille % 10,
+           rec->switches, rec->stack_size, rec->stack_used);
+}
+
+static void _csv_path(const stats_rec_path_t *rec)
+{
+    printf("path_latency,%s,%" PRIu32 ",%" PRIu32,
+           stats_path_stage_to_str(rec->stage), rec->count, rec->max_us);
+    for (unsigned i = 0; i < CONFIG_STATS_PATH_BUCKETS; i++) {
+        printf(",%" PRIu32, rec->buckets[i]);
+    }
+    printf("\n");
+}
+
+static void _csv_pktbuf(const stats_rec_pktbuf_t *rec)
+{
+    printf("pktbuf_stats,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32
+           ",%" PRIu32 "\n", rec->size, rec->used, rec->high_water,
+           rec->largest_free, rec->alloc_failed);
+}
+
+static void _csv_msgq(const stats_rec_msgq_t *rec)
+{
+    int len = strnlen(rec->name, sizeof(rec->name));
+
+    printf("msgq_stats,%d,%.*s,%u,%u,%u,%" PRIu32 "\n", rec->pid,
+           len ? len : 1, len ? rec->name : "-", rec->size, rec->used,
+           rec->high_water, rec->full);
+}
+
+static void _csv_rpl_parent(const stats_rec_rpl_parent_t *rec)
+{
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+    ipv6_addr_t addr;
+
+    memcpy(&addr, rec->addr, sizeof(addr));
+
+    printf("rpl_stats_parent,%d,%s,%d\n", rec->instance_id,
+           ipv6_addr_to_str(addr_str, &addr, sizeof(addr_str)), rec->rank);
+}
+
+static void _emit_csv(stats_rec_type_t type, const void *rec)
+{
+    switch (type) {
+    case STATS_REC_NETIF:
+        _csv_netif(rec);
+        break;
+    case STATS_REC_NEIGHBOR:
+        _csv_neighbor(rec);
+        break;
+    case STATS_REC_RPL:
+        _csv_rpl(rec);
+        break;
+    case STATS_REC_RPL_STATUS:
+        _csv_rpl_status(rec);
+        break;
+    case STATS_REC_RPL_INSTANCE:
+        _csv_rpl_instance(rec);
+        break;
+    case STATS_REC_RPL_DODAG:
+        _csv_rpl_dodag(rec);
+        break;
+    case STATS_REC_RPL_PARENT:
+        _csv_rpl_parent(rec);
+        break;
+    case STATS_REC_RPL_EVENT:
+        _csv_rpl_event(rec);
+        break;
+    case STATS_REC_SNAPSHOT:
+        _csv_snapshot(rec);
+        break;
+    case STATS_REC_FLOW:
+        _csv_flow(rec);
+        break;
+    case STATS_REC_THREAD:
+        _csv_thread(rec);
+        break;
+    case STATS_REC_PATH:
+        _csv_path(rec);
+        break;
+    case STATS_REC_PKTBUF:
+        _csv_pktbuf(rec);
+        break;
+    case STATS_REC_MSGQ:
+        _csv_msgq(rec);
+        break;
+    case STATS_REC_NB_WINDOW:
+        _csv_nb_window(rec);
+        break;
+    }
+}
+
+static void _emit_binary(stats_rec_type_t type, const void *rec, size_t len)
+{
+    uint8_t frame[STATS_FRAME_MAXLEN];
+    uint16_t crc;
+
+    frame[0] = STATS_FRAME_SYNC;
+    frame[1] = type;
+    frame[2] = len;
+    memcpy(&frame[3], rec, len);
+    crc = crc16_ccitt_update(0xFFFF, &frame[1], len + 2);
+    frame[3 + len] = crc & 0xFF;
+    frame[4 + len] = crc >> 8;
+    /* one write per frame so that text output cannot split it */
+    stdio_write(frame, len + 5);
+}
+
+static void _write(stats_rec_type_t type, const void *rec, size_t len)
+{
+    /* one record is one line (or frame), never split by the event log */
+    evlog_output_lock();
+    if (IS_ACTIVE(CONFIG_STATS_BINARY)) {
+        _emit_binary(type, rec, len);
+    }
+    else {
+        _emit_csv(type, rec);
+    }
+    evlog_output_unlock();
+}
+
+static uint32_t _hash(uint8_t type, const void *rec, size_t len)
+{
+    /* FNV-1a, a collision only delays a report until the next keyframe */
+    const uint8_t *bytes = rec;
+    uint32_t hash = (2166136261U ^ type) * 16777619U;
+
+    while (len--) {
+        hash = (hash ^ *bytes++) * 16777619U;
+    }
+    return hash;
+}
+
+static size_t _stable_len(stats_rec_type_t type, size_t len)
+{
+    /* the trickle timer counts down every second, report it on keyframes */
+    if (type == STATS_REC_RPL_DODAG) {
+        return offsetof(stats_rec_rpl_dodag_t, trickle_tc);
+    }
+    return len;
+}
+
+static bool _changed(stats_rec_type_t type, uint16_t key,
+                     const void *rec, size_t len)
+{
+    uint32_t hash = _hash(type, rec, _stable_len(type, len));
+    _cache_entry_t *unused = NULL;
+
+    for (unsigned i = 0; i < STATS_CACHE_SIZE; i++) {
+        _cache_entry_t *entry = &_cache[i];
+
+        if ((entry->type == type) && (entry->key == key)) {
+            bool changed = _keyframe || (entry->hash != hash);
+
+            entry->hash = hash;
+            entry->seen = 1;
+            return changed;
+        }
+        if ((entry->type == 0) && (unused == NULL)) {
+            unused = entry;
+        }
+    }
+    if (unused != NULL) {
+        unused->hash = hash;
+        unused->key = key;
+        unused->type = type;
+        unused->seen = 1;
+    }
+    return true;
+}
+
+static bool _cached(stats_rec_type_t type, uint16_t key)
+{
+    for (unsigned i = 0; i < STATS_CACHE_SIZE; i++) {
+        if ((_cache[i].type == type) && (_cache[i].key == key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Length of the identifying start of a record, the payload of its
+ * removal record */
+static size_t _id_len(stats_rec_type_t type)
+{
+    switch (type) {
+    case STATS_REC_NETIF:
+    case STATS_REC_RPL_STATUS:
+        return 2;
+    case STATS_REC_NEIGHBOR:
+        return offsetof(stats_rec_neighbor_t, fresh);
+    case STATS_REC_RPL_PARENT:
+        return offsetof(stats_rec_rpl_parent_t, rank);
+    case STATS_REC_PKTBUF:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+/* Where the identity of a record is kept, NULL if its key gives it */
+static uint8_t *_id_store(stats_rec_type_t type, uint16_t key)
+{
+    switch (type) {
+    case STATS_REC_NEIGHBOR:
+        return _nb_ids[(key >> 8) * NETSTATS_NB_SIZE + (key & 0xFF)];
+    case STATS_REC_RPL_PARENT:
+        return _parent_ids[key];
+    case STATS_REC_RPL_INSTANCE:
+    case STATS_REC_RPL_DODAG:
+        return _instance_ids[key];
+    default:
+        return NULL;
+    }
+}
+
+static void _csv_removed(stats_rec_type_t type, const uint8_t *id)
+{
+    static const char *names[] = {
+        [STATS_REC_NETIF] = "stats",
+        [STATS_REC_NEIGHBOR] = "neighbor_stats",
+        [STATS_REC_RPL] = "rpl_stats",
+        [STATS_REC_RPL_STATUS] = "rpl_status",
+        [STATS_REC_RPL_INSTANCE] = "rpl_stats_instance",
+        [STATS_REC_RPL_DODAG] = "rpl_stats_dodag",
+        [STATS_REC_RPL_PARENT] = "rpl_stats_parent",
+        [STATS_REC_FLOW] = "flow_stats",
+        [STATS_REC_THREAD] = "thread_stats",
+        [STATS_REC_PATH] = "path_latency",
+        [STATS_REC_PKTBUF] = "pktbuf_stats",
+        [STATS_REC_MSGQ] = "msgq_stats",
+    };
+    char l2addr_str[3 * L2UTIL_ADDR_MAX_LEN];
+    char addr_str[IPV6_ADDR_MAX_STR_LEN];
+    ipv6_addr_t addr;
+
+    printf("stats_removed,%s", names[type]);
+    switch (type) {
+    case STATS_REC_NETIF:
+        printf(",%s", _netstats_module_to_str(id[1]));
+        break;
+    case STATS_REC_NEIGHBOR:
+        printf(",%s", gnrc_netif_addr_to_str(&id[1], id[0], l2addr_str));
+        break;
+    case STATS_REC_RPL:
+        printf(",%s", _rpl_msg_to_str(id[0]));
+        break;
+    case STATS_REC_RPL_STATUS:
+        printf(",%s,%d", id[0] ? "parent" : "instance", id[1]);
+        break;
+    case STATS_REC_RPL_PARENT:
+        memcpy(&addr, &id[1], sizeof(addr));
+        printf(",%d,%s", id[0],
+               ipv6_addr_to_str(addr_str, &addr, sizeof(addr_str)));
+        break;
+    case STATS_REC_PATH:
+        printf(",%s", stats_path_stage_to_str(id[0]));
+        break;
+    case STATS_REC_PKTBUF:
+        break;
+    default:
+        printf(",%d", id[0]);
+        break;
+    }
+    printf("\n");
+}
+
+/* Reports that the record of a cache slot went away */
+static void _write_removed(stats_rec_type_t type, uint16_t key)
+{
+    uint8_t id[offsetof(stats_rec_rpl_parent_t, rank)];
+    const uint8_t *stored = _id_store(type, key);
+    size_t len = _id_len(type);
+
+    if (stored != NULL) {
+        memcpy(id, stored, len);
+    }
+    else if (type == STATS_REC_NETIF) {
+        id[0] = 0;
+        id[1] = key & 0xFF;
+    }
+    else if (len == 2) {
+        id[0] = key >> 8;
+        id[1] = key & 0xFF;
+    }
+    else {
+        id[0] = key & 0xFF;
+    }
+    evlog_output_lock();
+    if (IS_ACTIVE(CONFIG_STATS_BINARY)) {
+        _emit_binary(type, id, len);
+    }
+    else {
+        _csv_removed(type, id);
+    }
+    evlog_output_unlock();
+}
+
+static void _cache_sweep(void)
+{
+    /* report and forget the records that vanished, so that they are
+     * reported again when they return */
+    for (unsigned i = 0; i < STATS_CACHE_SIZE; i++) {
+        if (!_cache[i].seen && (_cache[i].type != 0)) {
+            _write_removed(_cache[i].type, _cache[i].key);
+            _cache[i].type = 0;
+        }
+        _cache[i].seen = 0;
+    }
+}
+
+static void _emit(stats_rec_type_t type, uint16_t key, const void *rec, size_t len)
+{
+    if (IS_ACTIVE(CONFIG_STATS_DELTA)) {
+        uint8_t *id = _id_store(type, key);
+
+        if (id != NULL) {
+            /* a slot reused by another neighbor, parent or instance within
+             * one snapshot: the previous one went away */
+            if (_cached(type, key) && memcmp(id, rec, _id_len(type))) {
+                _write_removed(type, key);
+            }
+            memcpy(id, rec, _id_len(type));
+        }
+        if (!_changed(type, key, rec, len)) {
+            return;
+        }
+    }
+    _write(type, rec, len);
+}
+
+static void _netif_stats(netif_t *iface, unsigned num, unsigned module)
+{
+    stats_rec_netif_t rec = { .module = module };
+    netstats_t *stats;
+    int res = netif_get_opt(iface, NETOPT_STATS, module, &stats, sizeof(&stats));
+
+    if (res >= 0) {
+        rec.success = 1;
+        rec.rx_count = stats->rx_count;
+        rec.rx_bytes = stats->rx_bytes;
+        rec.tx_count = stats->tx_unicast_count + stats->tx_mcast_count;
+        rec.tx_mcast_count = stats->tx_mcast_count;
+        rec.tx_bytes = stats->tx_bytes;
+        rec.tx_success = stats->tx_success;
+        rec.tx_failed = stats->tx_failed;
+    }
+    _emit(STATS_REC_NETIF, (num << 8) | module, &rec, sizeof(rec));
+}
+
+static void _neighbors(netif_t *dev, unsigned num)
+{
+    netstats_nb_t *stats = &dev->neighbors.pstats[0];
+
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; ++i) {
+        netstats_nb_t *entry = &stats[i];
+        stats_rec_neighbor_t rec = { 0 };
+
+        if (entry->l2_addr_len == 0) {
+            continue;
+        }
+        rec.l2_addr_len = entry->l2_addr_len;
+        memcpy(rec.l2_addr, entry->l2_addr, entry->l2_addr_len);
+        rec.fresh = netstats_nb_isfresh(dev, entry);
+        rec.freshness = entry->freshness;
+        rec.etx_percent = (100 * entry->etx) / NETSTATS_NB_ETX_DIVISOR;
+        rec.tx_count = entry->tx_count;
+        rec.rx_count = entry->rx_count;
+        rec.rssi = entry->rssi;
+        rec.lqi = entry->lqi;
+        rec.time_tx_avg = entry->time_tx_avg;
+        _emit(STATS_REC_NEIGHBOR, (num << 8) | i, &rec, sizeof(rec));
+    }
+}
+
+#if CONFIG_STATS_NB_WINDOW
+static void _nb_acc_add(_nb_acc_t *acc, int32_t value, bool first)
+{
+    int32_t diff;
+
+    if (first) {
+        *acc = (_nb_acc_t){ .first = value, .min = value, .max = value };
+    }
+    diff = value - acc->first;
+    acc->min = (value < acc->min) ? value : acc->min;
+    acc->max = (value > acc->max) ? value : acc->max;
+    acc->sum += diff;
+    acc->sum_sq += (int64_t)diff * diff;
+}
+
+static void _nb_acc_dist(const _nb_acc_t *acc, unsigned n,
+                         stats_nb_dist_t *dist)
+{
+    /* n * sum_sq - sum^2 = n^2 * variance, of the population */
+    uint64_t spread = n * acc->sum_sq - (uint64_t)(acc->sum * acc->sum);
+    uint64_t var_centi = (100 * spread + (uint64_t)n * n / 2) /
+                         ((uint64_t)n * n);
+    int64_t sum_centi = 100 * acc->sum;
+
+    dist->min = acc->min;
+    dist->max = acc->max;
+    /* rounded half away from zero */
+    dist->mean_centi = acc->first * 100 +
+                       ((sum_centi < 0) ? -((-sum_centi + n / 2) / n)
+                                        : (sum_centi + n / 2) / n);
+    dist->var_centi = (var_centi > UINT32_MAX) ? UINT32_MAX : var_centi;
+}
+
+static void _nb_window_close(_nb_window_t *win)
+{
+    stats_rec_nb_window_t rec = { 0 };
+
+    if (win->samples == 0) {
+        return;
+    }
+    rec.l2_addr_len = win->l2_addr_len;
+    memcpy(rec.l2_addr, win->l2_addr, sizeof(rec.l2_addr));
+    rec.samples = win->samples;
+    rec.tx_count = win->tx_count;
+    rec.rx_count = win->rx_count;
+    for (unsigned i = 0; i < STATS_NB_METRIC_NUMOF; i++) {
+        _nb_acc_dist(&win->acc[i], win->samples, &rec.dist[i]);
+    }
+    /* a summary of past samples, not state: bypasses the delta cache */
+    _write(STATS_REC_NB_WINDOW, &rec, sizeof(rec));
+    win->samples = 0;
+}
+
+static void _nb_sample(netif_t *dev, unsigned num)
+{
+    netstats_nb_t *stats = &dev->neighbors.pstats[0];
+
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; ++i) {
+        netstats_nb_t *entry = &stats[i];
+        _nb_window_t *win = &_nb_windows[num][i];
+        bool first;
+
+        if ((entry->l2_addr_len != win->l2_addr_len) ||
+            (memcmp(entry->l2_addr, win->l2_addr, win->l2_addr_len) != 0)) {
+            /* the slot now holds another neighbor, or none */
+            _nb_window_close(win);
+            memset(win->l2_addr, 0, sizeof(win->l2_addr));
+            memcpy(win->l2_addr, entry->l2_addr, entry->l2_addr_len);
+            win->l2_addr_len = entry->l2_addr_len;
+        }
+        if (entry->l2_addr_len == 0) {
+            continue;
+        }
+        first = (win->samples == 0);
+        _nb_acc_add(&win->acc[STATS_NB_RSSI], entry->rssi, first);
+        _nb_acc_add(&win->acc[STATS_NB_LQI], entry->lqi, first);
+        _nb_acc_add(&win->acc[STATS_NB_ETX],
+                    (100 * entry->etx) / NETSTATS_NB_ETX_DIVISOR, first);
+        _nb_acc_add(&win->acc[STATS_NB_TX_TIME], entry->time_tx_avg, first);
+        win->tx_count = entry->tx_count;
+        win->rx_count = entry->rx_count;
+        if (++win->samples >= CONFIG_STATS_NB_WINDOW) {
+            _nb_window_close(win);
+        }
+    }
+}
+#endif
+
+void stats_sample_neighbors(void)
+{
+#if CONFIG_STATS_NB_WINDOW
+    gnrc_netif_t *gnrc_netif = NULL;
+    unsigned num = 0;
+
+    while ((gnrc_netif = gnrc_netif_iter(gnrc_netif)) &&
+           (num < GNRC_NETIF_NUMOF)) {
+        _nb_sample(&gnrc_netif->netif, num);
+        num++;
+    }
+#endif
+}
+
+#define _RPL_REC(rec, msg_id, prefix)                                   \
+    do {                                                                \
+        (rec).msg = (msg_id);                                           \
+        (rec).rx_ucast_count = gnrc_rpl_netstats.prefix##_rx_ucast_count; \
+        (rec).tx_ucast_count = gnrc_rpl_netstats.prefix##_tx_ucast_count; \
+        (rec).rx_mcast_count = gnrc_rpl_netstats.prefix##_rx_mcast_count; \
+        (rec).tx_mcast_count = gnrc_rpl_netstats.prefix##_tx_mcast_count; \
+        (rec).rx_ucast_bytes = gnrc_rpl_netstats.prefix##_rx_ucast_bytes; \
+        (rec).tx_ucast_bytes = gnrc_rpl_netstats.prefix##_tx_ucast_bytes; \
+        (rec).rx_mcast_bytes = gnrc_rpl_netstats.prefix##_rx_mcast_bytes; \
+        (rec).tx_mcast_bytes = gnrc_rpl_netstats.prefix##_tx_mcast_bytes; \
+    } while (0)
+
+static void _rpl_stats(void)
+{
+    stats_rec_rpl_t rec;
+
+    _RPL_REC(rec, STATS_RPL_DIO, dio);
+    _emit(STATS_REC_RPL, rec.msg, &rec, sizeof(rec));
+    _RPL_REC(rec, STATS_RPL_DIS, dis);
+    _emit(STATS_REC_RPL, rec.msg, &rec, sizeof(rec));
+    _RPL_REC(rec, STATS_RPL_DAO, dao);
+    _emit(STATS_REC_RPL, rec.msg, &rec, sizeof(rec));
+    _RPL_REC(rec, STATS_RPL_DAO_ACK, dao_ack);
+    _emit(STATS_REC_RPL, rec.msg, &rec, sizeof(rec));
+}
+
+static void _rpl_event(const _rpl_last_t *last, stats_rpl_event_t event,
+                       const ipv6_addr_t *old_addr, const ipv6_addr_t *new_addr,
+                       uint16_t new_rank)
+{
+    stats_rec_rpl_event_t rec = {
+        .instance_id = last->instance_id,
+        .event = event,
+        .old_rank = last->rank,
+        .new_rank = new_rank,
+    };
+
+    memcpy(rec.old_addr, old_addr, sizeof(rec.old_addr));
+    memcpy(rec.new_addr, new_addr, sizeof(rec.new_addr));
+    _write(STATS_REC_RPL_EVENT, &rec, sizeof(rec));
+}
+
+static void _rpl_events(uint8_t i)
+{
+    gnrc_rpl_instance_t *inst = &gnrc_rpl_instances[i];
+    _rpl_last_t *last = &_rpl_last[i];
+    ipv6_addr_t dodag_id = IPV6_ADDR_UNSPECIFIED;
+    ipv6_addr_t parent = IPV6_ADDR_UNSPECIFIED;
+    uint16_t rank = 0;
+
+    if (inst->state != 0) {
+        last->instance_id = inst->id;
+        dodag_id = inst->dodag.dodag_id;
+        rank = inst->dodag.my_rank;
+        /* the preferred parent is kept at the head of the parent list */
+        if (inst->dodag.parents != NULL) {
+            parent = inst->dodag.parents->addr;
+        }
+    }
+
+    if (!ipv6_addr_equal(&dodag_id, &last->dodag_id)) {
+        _rpl_event(last, STATS_RPL_EVENT_DODAG, &last->dodag_id, &dodag_id, rank);
+        last->dodag_id = dodag_id;
+    }
+    if (!ipv6_addr_equal(&parent, &last->parent)) {
+        _rpl_event(last, STATS_RPL_EVENT_PARENT, &last->parent, &parent, rank);
+        last->parent = parent;
+    }
+    if (rank != last->rank) {
+        _rpl_event(last, STATS_RPL_EVENT_RANK, &last->parent, &parent, rank);
+        last->rank = rank;
+    }
+}
+
+static void _rpl_dodag_show(void)
+{
+    stats_rec_rpl_status_t status;
+
+    for (uint8_t i = 0; i < GNRC_RPL_INSTANCES_NUMOF; ++i) {
+        status.table = 0;
+        status.index = i;
+        status.state = gnrc_rpl_instances[i].state;
+        _emit(STATS_REC_RPL_STATUS, (status.table << 8) | i, &status, sizeof(status));
+    }
+
+    for (uint8_t i = 0; i < GNRC_RPL_PARENTS_NUMOF; ++i) {
+        status.table = 1;
+        status.index = i;
+        status.state = gnrc_rpl_parents[i].state;
+        _emit(STATS_REC_RPL_STATUS, (status.table << 8) | i, &status, sizeof(status));
+    }
+
+    gnrc_rpl_dodag_t *dodag = NULL;
+    uint64_t tc;
+
+    for (uint8_t i = 0; i < GNRC_RPL_INSTANCES_NUMOF; ++i) {
+        gnrc_rpl_instance_t *inst = &gnrc_rpl_instances[i];
+
+        if (IS_ACTIVE(CONFIG_STATS_DELTA)) {
+            _rpl_events(i);
+        }
+        if (inst->state == 0) {
+            continue;
+        }
+
+        dodag = &inst->dodag;
+
+        stats_rec_rpl_instance_t instance = {
+            .id = inst->id,
+            .iface = dodag->iface,
+            .mop = inst->mop,
+            .ocp = inst->of->ocp,
+            .min_hop_rank_inc = inst->min_hop_rank_inc,
+            .max_rank_inc = inst->max_rank_inc,
+        };
+        _emit(STATS_REC_RPL_INSTANCE, i, &instance, sizeof(instance));
+
+        tc = xtimer_left_usec(&dodag->trickle.msg_timer);
+        tc = (int64_t) tc == 0 ? 0 : tc / US_PER_SEC;
+
+        stats_rec_rpl_dodag_t rec = {
+            .instance_id = inst->id,
+            .rank = dodag->my_rank,
+            .leaf = (dodag->node_status == GNRC_RPL_LEAF_NODE),
+            .prefix_info = !!(dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO),
+            .dio_min = dodag->dio_min,
+            .dio_interval_doubl = dodag->dio_interval_doubl,
+            .trickle_k = dodag->trickle.k,
+            .trickle_c = dodag->trickle.c,
+            .trickle_tc = (uint32_t) (tc & 0xFFFFFFFF),
+        };
+        memcpy(rec.dodag_id, &dodag->dodag_id, sizeof(rec.dodag_id));
+        _emit(STATS_REC_RPL_DODAG, i, &rec, sizeof(rec));
+
+        gnrc_rpl_parent_t *parent = NULL;
+        LL_FOREACH(dodag->parents, parent) {
+            stats_rec_rpl_parent_t prec = {
+                .instance_id = inst->id,
+                .rank = parent->rank,
+            };
+            memcpy(prec.addr, &parent->addr, sizeof(prec.addr));
+            _emit(STATS_REC_RPL_PARENT, parent - gnrc_rpl_parents,
+                  &prec, sizeof(prec));
+        }
+    }
+}
+
+static void _flows(void)
+{
+    stats_flow_get_t get = _flow_get;
+
+    if (get == NULL) {
+        return;
+    }
+    for (unsigned i = 0; i < CONFIG_STATS_FLOWS_NUMOF; i++) {
+        stats_rec_flow_t rec = { 0 };
+
+        if (get(i, &rec)) {
+            _emit(STATS_REC_FLOW, i, &rec, sizeof(rec));
+        }
+    }
+}
+
+static void _threads(void)
+{
+#ifdef MODULE_SCHEDSTATISTICS
+    uint64_t total = 0;
+    /* all the deltas are taken at once, so that the shares add up */
+    unsigned state = irq_disable();
+
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        _thread_last_t *last = &_thread_last[pid - KERNEL_PID_FIRST];
+        schedstat_t *stat = &sched_pidlist[pid];
+
+        last->runtime_delta = stat->runtime_ticks - last->runtime;
+        last->schedules_delta = stat->schedules - last->schedules;
+        last->runtime = stat->runtime_ticks;
+        last->schedules = stat->schedules;
+        if (thread_get(pid) != NULL) {
+            total += last->runtime_delta;
+        }
+    }
+    irq_restore(state);
+#endif
+
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        const thread_t *thread = thread_get(pid);
+        stats_rec_thread_t rec = { 0 };
+
+        if (thread == NULL) {
+            continue;
+        }
+        rec.pid = pid;
+        rec.priority = thread->priority;
+#ifdef MODULE_SCHEDSTATISTICS
+        _thread_last_t *last = &_thread_last[pid - KERNEL_PID_FIRST];
+
+        if (total > 0) {
+            rec.cpu_permille = (last->runtime_delta * 1000 + total / 2) / total;
+        }
+        rec.switches = last->schedules_delta;
+#endif
+#ifdef DEVELHELP
+        strncpy(rec.name, thread_get_name(thread), sizeof(rec.name));
+        rec.stack_size = thread_get_stacksize(thread);
+        /* only meaningful for threads created with THREAD_CREATE_STACKTEST,
+         * which all GNRC threads are */
+        rec.stack_used = rec.stack_size -
+                         thread_measure_stack_free(thread_get_stackstart(thread));
+#endif
+        _emit(STATS_REC_THREAD, pid, &rec, sizeof(rec));
+    }
+}
+
+static void _path(void)
+{
+    stats_path_get_t get = _path_get;
+
+    if (get == NULL) {
+        return;
+    }
+    for (unsigned i = 0; i < STATS_PATH_NUMOF; i++) {
+        stats_rec_path_t rec = { 0 };
+
+        if (get(i, &rec)) {
+            _emit(STATS_REC_PATH, i, &rec, sizeof(rec));
+        }
+    }
+}
+
+static void _buffers(void)
+{
+#ifdef MODULE_BUFSTATS
+    bufstats_pktbuf_t pktbuf;
+
+    bufstats_pktbuf(&pktbuf);
+    stats_rec_pktbuf_t rec = {
+        .size = pktbuf.size,
+        .used = pktbuf.used,
+        .high_water = pktbuf.high_water,
+        .largest_free = pktbuf.largest_free,
+        .alloc_failed = pktbuf.alloc_failed,
+    };
+    _emit(STATS_REC_PKTBUF, 0, &rec, sizeof(rec));
+
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        stats_rec_msgq_t qrec = { 0 };
+        bufstats_queue_t queue;
+
+        if (!bufstats_queue(pid, &queue)) {
+            continue;
+        }
+        qrec.pid = pid;
+        qrec.size = queue.size;
+        qrec.used = queue.used;
+        qrec.high_water = queue.high_water;
+        qrec.full = queue.full;
+#ifdef DEVELHELP
+        strncpy(qrec.name, thread_get_name(thread_get(pid)), sizeof(qrec.name));
+#endif
+        _emit(STATS_REC_MSGQ, pid, &qrec, sizeof(qrec));
+    }
+#endif
+}
+
+void stats_set_path_source(stats_path_get_t get)
+{
+    _path_get = get;
+}
+
+void stats_set_flow_source(stats_flow_get_t get)
+{
+    _flow_get = get;
+}
+
+void stats_print_headers(void)
+{
+    evlog_output_lock();
+    if (CONFIG_STATS_NB_WINDOW) {
+        printf("neighbor_window,L2 address,Samples,Sent,Received,"
+               "RSSI min (dBm),RSSI max,RSSI mean,RSSI var,"
+               "LQI min,LQI max,LQI mean,LQI var,"
+               "ETX min (%%),ETX max,ETX mean,ETX var,"
+               "TX time min (µs),TX time max,TX time mean,TX time var\n");
+    }
+    else {
+        printf("neighbor_stats,L2 address,fresh,etx,sent,received,rssi (dBm),lqi,avg tx time (µs)\n");
+    }
+    printf("rpl_stats,Packet Type,Measurement Type,RX unicast,TX unicast,RX multicast,TX multicast\n");
+    printf("stats,success,layer,rx packets,rx bytes,tx packets,tx multicast packets,tx bytes,tx succeeded,tx errors\n");
+    printf("rpl_status,Type of table,Index of the table,Table status\n");
+    printf("rpl_stats_instance,Instance ID,Interface ID,Mode of Operation,Objective Code Point,Min Hop Rank Increase,Max Rank Increase\n");
+    printf("rpl_stats_dodag,Instance ID,IPv6 Adress,Rank,Role,Prefix Information,Trickle Interval Size Min,Trickle Interval Size Max,Trickle Redundancy Constant,Trickle Counter,Trickle TC\n");
+    printf("rpl_stats_parent,Instance ID,IPv6 Adress,Rank,Lifetime\n");
+    printf("flow_stats,Flow ID,Distribution,Parameter,Payload size,"
+           "Destination,Port,Active,Sent,Bytes,Dropped in stack,Offered,"
+           "Dropped at source\n");
+    if (IS_ACTIVE(CONFIG_STATS_THREADS)) {
+        printf("thread_stats,PID,Name,Priority,CPU (%%),Context switches,"
+               "Stack size,Stack used\n");
+    }
+    if (_path_get != NULL) {
+        /* bucket upper bounds, see CONFIG_STATS_PATH_BUCKETS */
+        printf("path_latency,Stage,Packets,Max (us)");
+        for (unsigned i = 0; i < CONFIG_STATS_PATH_BUCKETS - 1; i++) {
+            printf(",<%lu", 16UL << i);
+        }
+        printf(",>=%lu\n", 16UL << (CONFIG_STATS_PATH_BUCKETS - 2));
+    }
+    if (IS_USED(MODULE_BUFSTATS)) {
+        printf("pktbuf_stats,Size,Used,High water,Largest free,"
+               "Failed allocations\n");
+        printf("msgq_stats,PID,Name,Size,Used,High water,Full\n");
+    }
+    if (IS_ACTIVE(CONFIG_STATS_DELTA)) {
+        printf("rpl_event,Instance ID,Event,Old,New\n");
+        printf("stats_snapshot,Sequence,Keyframe\n");
+    }
+    evlog_output_unlock();
+}
+
+void stats_report(void)
+{
+    netif_t *netif = NULL;
+    gnrc_netif_t *gnrc_netif = NULL;
+    unsigned num;
+
+    if (IS_ACTIVE(CONFIG_STATS_DELTA)) {
+        stats_rec_snapshot_t snapshot = {
+            .seq = _snapshot_seq,
+            .keyframe = (_snapshot_seq % CONFIG_STATS_KEYFRAME_INTERVAL) == 0,
+        };
+
+        _keyframe = snapshot.keyframe;
+        _snapshot_seq++;
+        _write(STATS_REC_SNAPSHOT, &snapshot, sizeof(snapshot));
+    }
+
+    num = 0;
+    while ((netif = netif_iter(netif))) {
+        _netif_stats(netif, num, NETSTATS_LAYER2);
+        _netif_stats(netif, num, NETSTATS_IPV6);
+        num++;
+    }
+    num = 0;
+    while (!CONFIG_STATS_NB_WINDOW &&
+           (gnrc_netif = gnrc_netif_iter(gnrc_netif))) {
+        _neighbors(&gnrc_netif->netif, num);
+        num++;
+    }
+    _rpl_stats();
+    _rpl_dodag_show();
+    _flows();
+    _path();
+    _buffers();
+    if (IS_ACTIVE(CONFIG_STATS_THREADS)) {
+        _threads();
+    }
+
+    if (IS_ACTIVE(CONFIG_STATS_DELTA)) {
+        _cache_sweep();
+    }
+}
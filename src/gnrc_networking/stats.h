@@ -0,0 +1,532 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Network statistics reporting for the gnrc_networking firmware
+ *
+ * Every snapshot is made of records, one record type per CSV family printed
+ * by the firmware (`stats`, `neighbor_stats`, `rpl_stats`, ...). A record is
+ * either rendered as the historical CSV line(s) or, with
+ * `CONFIG_STATS_BINARY`, written as a binary frame:
+ *
+ *     | 0xFE | type | len | payload (len bytes) | CRC16 |
+ *
+ * The payload is the packed, little-endian record structure below. The CRC
+ * is CRC-16/CCITT-FALSE (poly 0x1021, seed 0xFFFF) over type, len and
+ * payload, transmitted little-endian. 0xFE never occurs in the UTF-8 text
+ * printed by the firmware, so frames and text lines can share the UART.
+ * `tools/stats_decode.py` turns a capture back into the CSV lines.
+ *
+ * With `CONFIG_STATS_DELTA`, a record is only reported when it differs from
+ * the last one reported for the same table slot, RPL DODAG membership,
+ * preferred parent and rank changes are reported as `rpl_event` records, and
+ * each snapshot starts with a `stats_snapshot` record. Every
+ * `CONFIG_STATS_KEYFRAME_INTERVAL` snapshots a keyframe reports all records
+ * again, so a reader can resync from any keyframe.
+ *
+ * A record that disappears in delta mode (e.g. a neighbor slot being freed)
+ * is reported at the end of the snapshot by a removal record of the same
+ * type. Its payload is only the fields identifying the record, i.e. the
+ * start of the record, shorter than a full one:
+ *
+ * | Record               | Removal payload                 |
+ * |----------------------|---------------------------------|
+ * | `stats`              | success (0), module             |
+ * | `neighbor_stats`     | l2_addr_len, l2_addr            |
+ * | `rpl_stats`          | msg                             |
+ * | `rpl_status`         | table, index                    |
+ * | `rpl_stats_instance` | id                              |
+ * | `rpl_stats_dodag`    | instance_id                     |
+ * | `rpl_stats_parent`   | instance_id, addr               |
+ * | `flow_stats`         | id                              |
+ * | `thread_stats`       | pid                             |
+ * | `path_latency`       | stage                           |
+ * | `pktbuf_stats`       | nothing                         |
+ * | `msgq_stats`         | pid                             |
+ *
+ * A slot taken over by another neighbor, parent or instance within one
+ * snapshot gets a removal record before the record of the newcomer.
+ *
+ * In CSV, it is a `stats_removed,<family>,<fields>` line, e.g.
+ * `stats_removed,neighbor_stats,12:34:56:78:9A:BC:DE:F0`, so that parsers of
+ * the families do not take it for a record.
+ *
+ * @}
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Emit binary frames instead of CSV lines
+ */
+#ifndef CONFIG_STATS_BINARY
+#define CONFIG_STATS_BINARY         0
+#endif
+
+/**
+ * @brief   Only report records that changed since they were last reported
+ */
+#ifndef CONFIG_STATS_DELTA
+#define CONFIG_STATS_DELTA          0
+#endif
+
+/**
+ * @brief   Number of snapshots between two keyframes in delta mode
+ *
+ * 1 makes every snapshot a keyframe, 0 is refused.
+ */
+#ifndef CONFIG_STATS_KEYFRAME_INTERVAL
+#define CONFIG_STATS_KEYFRAME_INTERVAL  (60U)
+#endif
+
+/**
+ * @brief   Number of traffic flows, each reported as a `flow_stats` record
+ */
+#ifndef CONFIG_STATS_FLOWS_NUMOF
+#define CONFIG_STATS_FLOWS_NUMOF    (4U)
+#endif
+
+/**
+ * @brief   Report a `thread_stats` record per thread
+ *
+ * The runtime and context switches need the schedstatistics module, the
+ * stack high-water mark DEVELHELP.
+ */
+#ifndef CONFIG_STATS_THREADS
+#define CONFIG_STATS_THREADS        (0)
+#endif
+
+/**
+ * @brief   Bytes of the thread name in a `thread_stats` record
+ */
+#ifndef CONFIG_STATS_THREAD_NAME_LEN
+#define CONFIG_STATS_THREAD_NAME_LEN    (12U)
+#endif
+
+/**
+ * @brief   Buckets of a `path_latency` histogram
+ *
+ * Bucket 0 counts the latencies below 16 us, bucket i > 0 those from
+ * 2^(i + 3) us to twice that, the last bucket everything above.
+ */
+#ifndef CONFIG_STATS_PATH_BUCKETS
+#define CONFIG_STATS_PATH_BUCKETS   (20U)
+#endif
+
+/**
+ * @brief   Samples per `neighbor_window` record, 0 to report the raw
+ *          `neighbor_stats` records instead
+ *
+ * With a window, the neighbor table is sampled every
+ * CONFIG_STATS_NB_SAMPLE_MS by stats_sample_neighbors() and each neighbor is
+ * reported once per window, as min, max, mean and variance of its RSSI, LQI,
+ * ETX and TX time.
+ */
+#ifndef CONFIG_STATS_NB_WINDOW
+#define CONFIG_STATS_NB_WINDOW      (0U)
+#endif
+
+/**
+ * @brief   Period of the neighbor table samples, in ms
+ */
+#ifndef CONFIG_STATS_NB_SAMPLE_MS
+#define CONFIG_STATS_NB_SAMPLE_MS   (250U)
+#endif
+
+/**
+ * @brief   First byte of a binary stats frame
+ */
+#define STATS_FRAME_SYNC            (0xFE)
+
+/**
+ * @brief   Record types, one per CSV family
+ */
+typedef enum {
+    STATS_REC_NETIF         = 1,    /**< `stats` */
+    STATS_REC_NEIGHBOR      = 2,    /**< `neighbor_stats` */
+    STATS_REC_RPL           = 3,    /**< `rpl_stats` */
+    STATS_REC_RPL_STATUS    = 4,    /**< `rpl_status` */
+    STATS_REC_RPL_INSTANCE  = 5,    /**< `rpl_stats_instance` */
+    STATS_REC_RPL_DODAG     = 6,    /**< `rpl_stats_dodag` */
+    STATS_REC_RPL_PARENT    = 7,    /**< `rpl_stats_parent` */
+    STATS_REC_RPL_EVENT     = 8,    /**< `rpl_event` (delta mode) */
+    STATS_REC_SNAPSHOT      = 9,    /**< `stats_snapshot` (delta mode) */
+    STATS_REC_FLOW          = 10,   /**< `flow_stats` */
+    STATS_REC_THREAD        = 11,   /**< `thread_stats` */
+    STATS_REC_PATH          = 12,   /**< `path_latency` */
+    STATS_REC_PKTBUF        = 13,   /**< `pktbuf_stats` */
+    STATS_REC_MSGQ          = 14,   /**< `msgq_stats` */
+    STATS_REC_NB_WINDOW     = 15,   /**< `neighbor_window` */
+} stats_rec_type_t;
+
+/**
+ * @brief   `stats` record: L2 or IPv6 netstats of an interface
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t success;                /**< 0 if the netstats are unavailable */
+    uint8_t module;                 /**< NETSTATS_LAYER2 or NETSTATS_IPV6 */
+    uint32_t rx_count;
+    uint32_t rx_bytes;
+    uint32_t tx_count;              /**< unicast + multicast */
+    uint32_t tx_mcast_count;
+    uint32_t tx_bytes;
+    uint32_t tx_success;
+    uint32_t tx_failed;
+} stats_rec_netif_t;
+
+/**
+ * @brief   `neighbor_stats` record: one netstats_nb_t slot
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t l2_addr_len;
+    uint8_t l2_addr[8];
+    uint8_t fresh;                  /**< 0 if the entry is STALE */
+    uint8_t freshness;
+    uint16_t etx_percent;           /**< ETX in percent */
+    uint16_t tx_count;
+    uint16_t rx_count;
+    int8_t rssi;
+    uint8_t lqi;
+    uint32_t time_tx_avg;
+} stats_rec_neighbor_t;
+
+/**
+ * @brief   Metrics of a `neighbor_window` record
+ */
+typedef enum {
+    STATS_NB_RSSI           = 0,    /**< dBm */
+    STATS_NB_LQI            = 1,
+    STATS_NB_ETX            = 2,    /**< percent */
+    STATS_NB_TX_TIME        = 3,    /**< time_tx_avg, us */
+    STATS_NB_METRIC_NUMOF,
+} stats_nb_metric_t;
+
+/**
+ * @brief   Distribution of one metric over a window
+ */
+typedef struct __attribute__((packed)) {
+    int32_t min;
+    int32_t max;
+    int32_t mean_centi;             /**< mean, in hundredths */
+    uint32_t var_centi;             /**< variance, in hundredths, saturated
+                                         at UINT32_MAX */
+} stats_nb_dist_t;
+
+/**
+ * @brief   `neighbor_window` record: one neighbor over one window
+ *
+ * A window is cut short when the neighbor leaves its table slot.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t l2_addr_len;
+    uint8_t l2_addr[8];
+    uint16_t samples;
+    uint16_t tx_count;              /**< at the last sample */
+    uint16_t rx_count;              /**< at the last sample */
+    stats_nb_dist_t dist[STATS_NB_METRIC_NUMOF];
+} stats_rec_nb_window_t;
+
+/**
+ * @brief   RPL control message types of a `rpl_stats` record
+ */
+typedef enum {
+    STATS_RPL_DIO       = 0,
+    STATS_RPL_DIS       = 1,
+    STATS_RPL_DAO       = 2,
+    STATS_RPL_DAO_ACK   = 3,
+    STATS_RPL_NUMOF,
+} stats_rpl_msg_t;
+
+/**
+ * @brief   `rpl_stats` record: packets and bytes lines of one message type
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t msg;                    /**< stats_rpl_msg_t */
+    uint32_t rx_ucast_count;
+    uint32_t tx_ucast_count;
+    uint32_t rx_mcast_count;
+    uint32_t tx_mcast_count;
+    uint32_t rx_ucast_bytes;
+    uint32_t tx_ucast_bytes;
+    uint32_t rx_mcast_bytes;
+    uint32_t tx_mcast_bytes;
+} stats_rec_rpl_t;
+
+/**
+ * @brief   `rpl_status` record: state of one instance or parent table slot
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t table;                  /**< 0: instance, 1: parent */
+    uint8_t index;
+    uint8_t state;
+} stats_rec_rpl_status_t;
+
+/**
+ * @brief   `rpl_stats_instance` record
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t id;
+    int16_t iface;
+    uint8_t mop;
+    uint16_t ocp;
+    uint16_t min_hop_rank_inc;
+    uint16_t max_rank_inc;
+} stats_rec_rpl_instance_t;
+
+/**
+ * @brief   `rpl_stats_dodag` record
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t instance_id;
+    uint8_t dodag_id[16];
+    uint16_t rank;
+    uint8_t leaf;                   /**< 1: Leaf, 0: Router */
+    uint8_t prefix_info;
+    uint8_t dio_min;
+    uint8_t dio_interval_doubl;
+    uint8_t trickle_k;
+    uint16_t trickle_c;
+    uint32_t trickle_tc;            /**< seconds left on the trickle timer */
+} stats_rec_rpl_dodag_t;
+
+/**
+ * @brief   `rpl_stats_parent` record
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t instance_id;
+    uint8_t addr[16];
+    uint16_t rank;
+} stats_rec_rpl_parent_t;
+
+/**
+ * @brief   RPL events of a `rpl_event` record
+ */
+typedef enum {
+    STATS_RPL_EVENT_DODAG   = 0,    /**< joined, left or changed DODAG */
+    STATS_RPL_EVENT_PARENT  = 1,    /**< preferred parent changed */
+    STATS_RPL_EVENT_RANK    = 2,    /**< own rank changed */
+} stats_rpl_event_t;
+
+/**
+ * @brief   `rpl_event` record
+ *
+ * Addresses are all-zero when there is no DODAG or parent, ranks are only
+ * meaningful for STATS_RPL_EVENT_RANK.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t instance_id;
+    uint8_t event;                  /**< stats_rpl_event_t */
+    uint16_t old_rank;
+    uint16_t new_rank;
+    uint8_t old_addr[16];
+    uint8_t new_addr[16];
+} stats_rec_rpl_event_t;
+
+/**
+ * @brief   `stats_snapshot` record, starts every snapshot in delta mode
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t seq;
+    uint8_t keyframe;
+} stats_rec_snapshot_t;
+
+/**
+ * @brief   Distributions of the time between two packets of a flow
+ */
+typedef enum {
+    STATS_FLOW_EXPONENTIAL  = 0,    /**< Poisson traffic */
+    STATS_FLOW_PERIODIC     = 1,    /**< constant bit rate */
+    STATS_FLOW_ONOFF        = 2,    /**< Poisson bursts separated by silences */
+    STATS_FLOW_TRACE        = 3,    /**< replay of a recorded trace */
+    STATS_FLOW_NUMOF,
+} stats_flow_dist_t;
+
+/**
+ * @brief   `flow_stats` record: settings and counters of one traffic flow
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t id;
+    uint8_t dist;                   /**< stats_flow_dist_t */
+    uint8_t active;                 /**< 0 if stopped or paused */
+    uint16_t size;                  /**< payload size */
+    uint16_t port;
+    uint8_t addr[16];               /**< destination */
+    uint32_t param;                 /**< rate (packets/s) or period (s), in
+                                         millionths, 0 for a trace */
+    uint32_t sent;                  /**< packets handed to the stack */
+    uint32_t bytes;                 /**< payload bytes handed to the stack */
+    uint32_t dropped_stack;         /**< packets that could not be built or
+                                         sent */
+    uint32_t offered;               /**< samples generated */
+    uint32_t dropped_src;           /**< samples refused by the admission
+                                         control */
+} stats_rec_flow_t;
+
+/**
+ * @brief   `thread_stats` record: scheduling and stack use of one thread
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t pid;
+    uint8_t priority;
+    char name[CONFIG_STATS_THREAD_NAME_LEN];    /**< not terminated if full */
+    uint16_t cpu_permille;          /**< share of the CPU time since the
+                                         previous report */
+    uint32_t switches;              /**< times the thread was scheduled since
+                                         the previous report */
+    uint16_t stack_size;
+    uint16_t stack_used;            /**< high-water mark, 0 if unknown */
+} stats_rec_thread_t;
+
+/**
+ * @brief   `pktbuf_stats` record: packet buffer occupancy, in bytes
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t size;                  /**< 0 if the occupancy is not known */
+    uint32_t used;
+    uint32_t high_water;            /**< since boot or `bufstats reset` */
+    uint32_t largest_free;
+    uint32_t alloc_failed;          /**< allocations that failed since boot */
+} stats_rec_pktbuf_t;
+
+/**
+ * @brief   `msgq_stats` record: message queue occupancy of one thread
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t pid;
+    char name[CONFIG_STATS_THREAD_NAME_LEN];    /**< empty if unknown */
+    uint16_t size;
+    uint16_t used;
+    uint16_t high_water;            /**< since boot or `bufstats reset` */
+    uint32_t full;                  /**< messages not delivered since boot */
+} stats_rec_msgq_t;
+
+/**
+ * @brief   Stages of the packet path of a `path_latency` record
+ */
+typedef enum {
+    STATS_PATH_GEN          = 0,    /**< sample to hand-over to UDP */
+    STATS_PATH_UDP          = 1,    /**< UDP queue and thread, to the
+                                         hand-over to IPv6 */
+    STATS_PATH_IPV6         = 2,    /**< IPv6 queue and thread, to the
+                                         hand-over to 6LoWPAN or, without
+                                         6LoWPAN, to the driver */
+    STATS_PATH_SIXLOWPAN    = 3,    /**< 6LoWPAN and netif queues and
+                                         threads, to the driver */
+    STATS_PATH_TX_START     = 4,    /**< driver to transmission start */
+    STATS_PATH_TX_DONE      = 5,    /**< transmission start to its end,
+                                         CSMA and retransmissions included */
+    STATS_PATH_TOTAL        = 6,    /**< sample to the end of transmission */
+    STATS_PATH_NUMOF,
+} stats_path_stage_t;
+
+/**
+ * @brief   `path_latency` record: latency histogram of one stage since boot
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t stage;                  /**< stats_path_stage_t */
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[CONFIG_STATS_PATH_BUCKETS];
+} stats_rec_path_t;
+
+/**
+ * @brief   Bucket of a latency in a `path_latency` histogram
+ */
+static inline unsigned stats_path_bucket(uint32_t us)
+{
+    unsigned bucket = (us < 16) ? 0 : (31 - __builtin_clz(us)) - 3;
+
+    return (bucket < CONFIG_STATS_PATH_BUCKETS) ? bucket
+                                                : CONFIG_STATS_PATH_BUCKETS - 1;
+}
+
+/**
+ * @brief   Reads the histogram of a stage of the packet path
+ *
+ * @param[in] stage     stats_path_stage_t
+ * @param[out] rec      record to fill
+ *
+ * @return  false if the stage is not measured
+ */
+typedef bool (*stats_path_get_t)(unsigned stage, stats_rec_path_t *rec);
+
+/**
+ * @brief   Name of a stats_path_stage_t in the CSV output
+ */
+const char *stats_path_stage_to_str(uint8_t stage);
+
+/**
+ * @brief   Set the source of the `path_latency` records of each report
+ *
+ * Call before the stats thread starts, the header line is printed only when
+ * a source is set.
+ *
+ * @param[in] get       called from the stats thread, NULL for none
+ */
+void stats_set_path_source(stats_path_get_t get);
+
+/**
+ * @brief   Reads the record of a traffic flow
+ *
+ * @param[in] idx       flow index, from 0 to CONFIG_STATS_FLOWS_NUMOF - 1
+ * @param[out] rec      record to fill
+ *
+ * @return  false if there is no such flow
+ */
+typedef bool (*stats_flow_get_t)(unsigned idx, stats_rec_flow_t *rec);
+
+/**
+ * @brief   Name of a stats_flow_dist_t in the CSV output and the shell
+ */
+const char *stats_flow_dist_to_str(uint8_t dist);
+
+/**
+ * @brief   Set the source of the `flow_stats` records of each report
+ *
+ * @param[in] get       called from the stats thread, NULL for none
+ */
+void stats_set_flow_source(stats_flow_get_t get);
+
+/**
+ * @brief   Print the CSV header lines of every record family
+ *
+ * The headers are printed as text in both output formats so that decoded
+ * binary captures read exactly like CSV captures.
+ */
+void stats_print_headers(void);
+
+/**
+ * @brief   Report one snapshot of all network statistics
+ *
+ * The neighbors are only part of it without CONFIG_STATS_NB_WINDOW.
+ */
+void stats_report(void);
+
+/**
+ * @brief   Add a sample of every neighbor to its window, report the
+ *          windows that are complete
+ *
+ * Call every CONFIG_STATS_NB_SAMPLE_MS when CONFIG_STATS_NB_WINDOW is set.
+ */
+void stats_sample_neighbors(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STATS_H */
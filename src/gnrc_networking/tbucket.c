@@ -0,0 +1,43 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Token bucket limiting the packets a node offers to its stack
+ *
+ * @}
+ */
+
+#include "tbucket.h"
+
+void tbucket_init(tbucket_t *tb, uint32_t interval_us, uint32_t depth)
+{
+    tb->interval_us = interval_us;
+    tb->depth = (depth > 0) ? depth : 1;
+    tb->tat_us = 0;
+}
+
+bool tbucket_take(tbucket_t *tb, uint64_t now_us)
+{
+    /* the bucket holds depth - 1 tokens beyond the one being taken */
+    uint64_t tolerance = (uint64_t)tb->interval_us * (tb->depth - 1);
+
+    if (!tbucket_enabled(tb)) {
+        return true;
+    }
+    if (tb->tat_us < now_us) {
+        /* full: the unused tokens are lost */
+        tb->tat_us = now_us;
+    }
+    else if (tb->tat_us - now_us > tolerance) {
+        return false;
+    }
+    tb->tat_us += tb->interval_us;
+    return true;
+}
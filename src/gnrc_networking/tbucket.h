@@ -0,0 +1,75 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Token bucket limiting the packets a node offers to its stack
+ *
+ * Implemented as the equivalent virtual scheduling algorithm: instead of a
+ * token count refilled over time, the bucket keeps the time at which it
+ * would be full again, so that a check is one comparison and no division.
+ * A bucket of rate r and depth b admits bursts of b packets and, over time,
+ * r packets per second.
+ *
+ * The bucket has no RIOT dependency, times are given by the caller.
+ *
+ * @}
+ */
+
+#ifndef TBUCKET_H
+#define TBUCKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Token bucket
+ */
+typedef struct {
+    uint32_t interval_us;   /**< time to earn a token, 0 if disabled */
+    uint32_t depth;         /**< tokens the bucket holds when full */
+    uint64_t tat_us;        /**< time at which the bucket is full again */
+} tbucket_t;
+
+/**
+ * @brief   Set the rate and depth of a bucket, which starts full
+ *
+ * @param[out] tb           bucket
+ * @param[in] interval_us   time between two tokens, 0 to admit everything
+ * @param[in] depth         size of the bursts, at least 1
+ */
+void tbucket_init(tbucket_t *tb, uint32_t interval_us, uint32_t depth);
+
+/**
+ * @brief   Take a token if there is one
+ *
+ * @param[in,out] tb    bucket
+ * @param[in] now_us    current time, never going backwards
+ *
+ * @return  true if the packet is admitted
+ */
+bool tbucket_take(tbucket_t *tb, uint64_t now_us);
+
+/**
+ * @brief   Check whether a bucket limits anything
+ */
+static inline bool tbucket_enabled(const tbucket_t *tb)
+{
+    return tb->interval_us != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TBUCKET_H */
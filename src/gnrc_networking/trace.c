@@ -0,0 +1,96 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Recorded traffic traces for the trace-replay generator
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "trace.h"
+
+/* Reads an unsigned LEB128 number of at most 32 bits */
+static int _varint(const uint8_t *buf, size_t len, size_t *pos, uint32_t *value)
+{
+    uint32_t res = 0;
+
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) {
+            return -EINVAL;
+        }
+        uint8_t byte = buf[(*pos)++];
+
+        res |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = res;
+            return 0;
+        }
+    }
+    return -EINVAL;
+}
+
+void trace_rewind(trace_cursor_t *cur)
+{
+    cur->pos = TRACE_MAGIC_LEN;
+    cur->size = 0;
+}
+
+int trace_next(const uint8_t *buf, size_t len, trace_cursor_t *cur,
+               trace_rec_t *rec)
+{
+    size_t pos = cur->pos;
+    uint32_t delta, zigzag;
+
+    if (pos >= len) {
+        return -ENOENT;
+    }
+    if ((_varint(buf, len, &pos, &delta) < 0) ||
+        (_varint(buf, len, &pos, &zigzag) < 0)) {
+        return -EINVAL;
+    }
+    rec->delta_us = delta;
+    rec->size = cur->size + (int32_t)((zigzag >> 1) ^ -(zigzag & 1));
+    cur->pos = pos;
+    cur->size = rec->size;
+    return 0;
+}
+
+int trace_check(const uint8_t *buf, size_t len, uint32_t *count,
+                uint64_t *duration_us)
+{
+    trace_cursor_t cur;
+    trace_rec_t rec;
+    uint32_t n = 0;
+    uint64_t duration = 0;
+    int res;
+
+    if ((len < TRACE_MAGIC_LEN) ||
+        (memcmp(buf, TRACE_MAGIC, TRACE_MAGIC_LEN) != 0)) {
+        return -EINVAL;
+    }
+    trace_rewind(&cur);
+    while ((res = trace_next(buf, len, &cur, &rec)) == 0) {
+        n++;
+        duration += rec.delta_us;
+    }
+    if (res != -ENOENT) {
+        return res;
+    }
+    if (count != NULL) {
+        *count = n;
+    }
+    if (duration_us != NULL) {
+        *duration_us = duration;
+    }
+    return (n > 0) ? 0 : -ENOENT;
+}
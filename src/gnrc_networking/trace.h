@@ -0,0 +1,107 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Recorded traffic traces for the trace-replay generator
+ *
+ * A trace is the magic TRACE_MAGIC followed by one record per packet, each
+ * made of two unsigned LEB128 varints:
+ *
+ * - the time since the previous packet in microseconds (for the first
+ *   packet, the time since the last one when the trace loops)
+ * - the zigzag-encoded difference between the payload size and the one of
+ *   the previous packet (0 for the first packet)
+ *
+ * so a packet of a steady flow with gaps below 16 ms takes 3 bytes.
+ * tools/trace_tool.py builds traces from CSV files or from the udp,... lines
+ * of a recorded log. A trace is linked into the image with `TRACE_FILE` or
+ * uploaded over the shell with the `trace` command.
+ *
+ * The decoder has no RIOT dependency.
+ *
+ * @}
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   First bytes of a trace
+ */
+#define TRACE_MAGIC         "GNT1"
+
+/**
+ * @brief   Length of TRACE_MAGIC
+ */
+#define TRACE_MAGIC_LEN     (4U)
+
+/**
+ * @brief   One packet of a trace
+ */
+typedef struct {
+    uint32_t delta_us;      /**< time since the previous packet */
+    uint16_t size;          /**< payload size */
+} trace_rec_t;
+
+/**
+ * @brief   Read position in a trace
+ */
+typedef struct {
+    size_t pos;             /**< offset of the next record */
+    uint16_t size;          /**< payload size of the previous record */
+} trace_cursor_t;
+
+/**
+ * @brief   Check a whole trace
+ *
+ * @param[in] buf       trace
+ * @param[in] len       length of @p buf
+ * @param[out] count    number of packets, may be NULL
+ * @param[out] duration_us  sum of the time deltas, may be NULL
+ *
+ * @return  0 if the trace holds at least one packet
+ * @return  -EINVAL on a wrong magic or a truncated record
+ * @return  -ENOENT if the trace is empty
+ */
+int trace_check(const uint8_t *buf, size_t len, uint32_t *count,
+                uint64_t *duration_us);
+
+/**
+ * @brief   Move @p cur to the first packet of a trace
+ */
+void trace_rewind(trace_cursor_t *cur);
+
+/**
+ * @brief   Read the next packet of a trace
+ *
+ * @param[in] buf       trace
+ * @param[in] len       length of @p buf
+ * @param[in,out] cur   read position
+ * @param[out] rec      the packet
+ *
+ * @return  0 on success
+ * @return  -ENOENT at the end of the trace
+ * @return  -EINVAL on a truncated record, @p cur is not moved
+ */
+int trace_next(const uint8_t *buf, size_t len, trace_cursor_t *cur,
+               trace_rec_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
@@ -0,0 +1,141 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Deadline-ordered scheduler for the traffic generators
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "xtimer.h"
+
+#include "txsched.h"
+
+#define TXSCHED_MSG_WAKEUP  (0x5e01)
+
+static txsched_event_t *_queue;
+static mutex_t _lock = MUTEX_INIT;
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+
+/* must be called with _lock held */
+static void _insert(txsched_event_t *event)
+{
+    txsched_event_t **prev = &_queue;
+
+    /* FIFO among equal deadlines */
+    while ((*prev != NULL) && ((*prev)->deadline <= event->deadline)) {
+        prev = &(*prev)->next;
+    }
+    event->next = *prev;
+    *prev = event;
+}
+
+/* the event is due before the one the scheduler sleeps for */
+static void _wakeup(void)
+{
+    if ((_pid != KERNEL_PID_UNDEF) && (_pid != thread_getpid())) {
+        msg_t msg = { .type = TXSCHED_MSG_WAKEUP };
+
+        msg_try_send(&msg, _pid);
+    }
+}
+
+void txsched_add(txsched_event_t *event, uint32_t delay)
+{
+    bool wakeup;
+
+    mutex_lock(&_lock);
+    event->deadline = xtimer_now_usec64() + delay;
+    _insert(event);
+    wakeup = (_queue == event);
+    mutex_unlock(&_lock);
+
+    if (wakeup) {
+        _wakeup();
+    }
+}
+
+bool txsched_reschedule(txsched_event_t *event, uint32_t delay)
+{
+    txsched_event_t **prev = &_queue;
+    bool queued, wakeup = false;
+
+    mutex_lock(&_lock);
+    while ((*prev != NULL) && (*prev != event)) {
+        prev = &(*prev)->next;
+    }
+    queued = (*prev != NULL);
+    if (queued) {
+        *prev = event->next;
+        event->deadline = xtimer_now_usec64() + delay;
+        _insert(event);
+        wakeup = (_queue == event);
+    }
+    mutex_unlock(&_lock);
+
+    /* moved later, the scheduler wakes up at the old deadline and finds
+     * nothing due */
+    if (wakeup) {
+        _wakeup();
+    }
+    return queued;
+}
+
+static void *_txsched_thread(void *arg)
+{
+    (void)arg;
+    msg_t msg_queue[CONFIG_TXSCHED_MSG_QUEUE_SIZE];
+    msg_t msg;
+
+    msg_init_queue(msg_queue, CONFIG_TXSCHED_MSG_QUEUE_SIZE);
+
+    while (1) {
+        txsched_event_t *event;
+        uint64_t now;
+
+        mutex_lock(&_lock);
+        event = _queue;
+        if (event == NULL) {
+            mutex_unlock(&_lock);
+            msg_receive(&msg);
+            continue;
+        }
+        now = xtimer_now_usec64();
+        if (event->deadline > now) {
+            mutex_unlock(&_lock);
+            /* woken up early by txsched_add() or by the timeout, re-check */
+            xtimer_msg_receive_timeout64(&msg, event->deadline - now);
+            continue;
+        }
+        _queue = event->next;
+        mutex_unlock(&_lock);
+
+        uint32_t delay = event->cb(event);
+
+        if (delay != TXSCHED_STOP) {
+            mutex_lock(&_lock);
+            event->deadline += delay;
+            _insert(event);
+            mutex_unlock(&_lock);
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t txsched_start(char *stack, int stacksize, uint8_t priority)
+{
+    _pid = thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _txsched_thread, NULL, "read_sensors_thread");
+    return _pid;
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     examples
+ * @{
+ *
+ * @file
+ * @brief       Deadline-ordered scheduler for the traffic generators
+ *
+ * A single thread keeps a queue of pending emissions sorted by absolute
+ * deadline and runs the callback of the earliest one when it is due. The
+ * next deadline of an event is computed from its previous deadline, not
+ * from the time the callback returned, so the time spent emitting does not
+ * accumulate as drift.
+ *
+ * @}
+ */
+
+#ifndef TXSCHED_H
+#define TXSCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of the message queue of the scheduler thread
+ */
+#ifndef CONFIG_TXSCHED_MSG_QUEUE_SIZE
+#define CONFIG_TXSCHED_MSG_QUEUE_SIZE   (4)
+#endif
+
+/**
+ * @brief   Callback return value to remove an event from the queue
+ */
+#define TXSCHED_STOP                    (UINT32_MAX)
+
+/**
+ * @brief   Event type
+ */
+typedef struct txsched_event txsched_event_t;
+
+/**
+ * @brief   Emission callback
+ *
+ * @param[in] event     the event that is due
+ *
+ * @return  delay in microseconds from this deadline to the next one
+ * @return  TXSCHED_STOP to remove the event from the queue
+ */
+typedef uint32_t (*txsched_cb_t)(txsched_event_t *event);
+
+/**
+ * @brief   A recurring emission
+ */
+struct txsched_event {
+    txsched_event_t *next;      /**< next event in deadline order */
+    uint64_t deadline;          /**< absolute deadline in microseconds */
+    txsched_cb_t cb;            /**< emission callback */
+    void *arg;                  /**< callback argument */
+};
+
+/**
+ * @brief   Queue an event
+ *
+ * Can be called before and after txsched_start(), from any thread.
+ *
+ * @param[in] event     event to queue, must not already be queued
+ * @param[in] delay     delay of the first emission from now in microseconds
+ */
+void txsched_add(txsched_event_t *event, uint32_t delay);
+
+/**
+ * @brief   Move a queued event to a new deadline
+ *
+ * Can be called from any thread. An event whose callback is running is not
+ * queued: its callback sets its next deadline.
+ *
+ * @param[in] event     event to move
+ * @param[in] delay     delay of its next emission from now in microseconds
+ *
+ * @return  true if the event was queued and has been moved
+ */
+bool txsched_reschedule(txsched_event_t *event, uint32_t delay);
+
+/**
+ * @brief   Start the scheduler thread
+ *
+ * @return  PID of the scheduler thread
+ */
+kernel_pid_t txsched_start(char *stack, int stacksize, uint8_t priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TXSCHED_H */
@@ -0,0 +1,289 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     bufstats
+ * @{
+ *
+ * @file
+ * @brief       Occupancy, high-water marks and drops of the packet buffer
+ *              and of the message queues of all threads
+ *
+ * @}
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cib.h"
+#include "irq.h"
+#include "msg.h"
+#include "thread.h"
+
+#include "net/gnrc/pktbuf.h"
+
+#include "bufstats.h"
+
+#define PID_NUMOF   (KERNEL_PID_LAST + 1)
+
+#if CONFIG_BUFSTATS_PKTBUF_USAGE && defined(MODULE_GNRC_PKTBUF_STATIC)
+#define PKTBUF_USAGE    1
+/* appended to gnrc_pktbuf_static.c by the firmware builder */
+void gnrc_pktbuf_usage(size_t *used, size_t *largest_free);
+#else
+#define PKTBUF_USAGE    0
+#endif
+
+static uint32_t _pktbuf_high_water;
+static uint32_t _pktbuf_failed;
+static uint16_t _queue_high_water[PID_NUMOF];
+static uint32_t _queue_full[PID_NUMOF];
+
+/* the real functions, see the --wrap flags in Makefile.include */
+int __real_msg_send(msg_t *m, kernel_pid_t target_pid);
+int __real_msg_try_send(msg_t *m, kernel_pid_t target_pid);
+int __real_msg_send_int(msg_t *m, kernel_pid_t target_pid);
+gnrc_pktsnip_t *__real_gnrc_pktbuf_add(gnrc_pktsnip_t *next, const void *data,
+                                       size_t size, gnrc_nettype_t type);
+gnrc_pktsnip_t *__real_gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt);
+
+static unsigned _queue_used(const thread_t *thread)
+{
+    /* the cast drops the const of the argument of cib_avail() in older
+     * releases */
+    return cib_avail((cib_t *)&thread->msg_queue);
+}
+
+/* Called after every send, also from interrupts */
+static void _queued(kernel_pid_t pid, int res)
+{
+    const thread_t *thread;
+    unsigned state;
+
+    if (!pid_is_valid(pid)) {
+        return;
+    }
+    state = irq_disable();
+    if (res == 0) {
+        /* full queue, or no queue and the receiver was not waiting */
+        _queue_full[pid]++;
+    }
+    else if ((res > 0) && ((thread = thread_get(pid)) != NULL) &&
+             thread_has_msg_queue(thread)) {
+        unsigned used = _queue_used(thread);
+
+        if (used > _queue_high_water[pid]) {
+            _queue_high_water[pid] = used;
+        }
+    }
+    irq_restore(state);
+}
+
+int __wrap_msg_send(msg_t *m, kernel_pid_t target_pid)
+{
+    int res = __real_msg_send(m, target_pid);
+
+    _queued(target_pid, res);
+    return res;
+}
+
+int __wrap_msg_try_send(msg_t *m, kernel_pid_t target_pid)
+{
+    int res = __real_msg_try_send(m, target_pid);
+
+    _queued(target_pid, res);
+    return res;
+}
+
+int __wrap_msg_send_int(msg_t *m, kernel_pid_t target_pid)
+{
+    int res = __real_msg_send_int(m, target_pid);
+
+    _queued(target_pid, res);
+    return res;
+}
+
+static uint32_t _pktbuf_used(uint32_t *largest_free)
+{
+#if PKTBUF_USAGE
+    size_t used, largest;
+
+    gnrc_pktbuf_usage(&used, &largest);
+    if (largest_free != NULL) {
+        *largest_free = largest;
+    }
+    return used;
+#else
+    if (largest_free != NULL) {
+        *largest_free = 0;
+    }
+    return 0;
+#endif
+}
+
+/* Raises the packet buffer high-water mark to used */
+static void _pktbuf_sampled(uint32_t used)
+{
+    unsigned state = irq_disable();
+
+    if (used > _pktbuf_high_water) {
+        _pktbuf_high_water = used;
+    }
+    irq_restore(state);
+}
+
+/* gnrc_pktbuf_usage() walks the free list under the packet buffer mutex,
+ * too slow for every allocation: the occupancy is only sampled when an
+ * allocation fails, the buffer being close to full then, and when the
+ * statistics are read */
+static void _allocated(bool success)
+{
+    unsigned state;
+
+    if (success) {
+        return;
+    }
+    state = irq_disable();
+    _pktbuf_failed++;
+    irq_restore(state);
+    if (PKTBUF_USAGE) {
+        _pktbuf_sampled(_pktbuf_used(NULL));
+    }
+}
+
+gnrc_pktsnip_t *__wrap_gnrc_pktbuf_add(gnrc_pktsnip_t *next, const void *data,
+                                       size_t size, gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt = __real_gnrc_pktbuf_add(next, data, size, type);
+
+    _allocated(pkt != NULL);
+    return pkt;
+}
+
+gnrc_pktsnip_t *__wrap_gnrc_pktbuf_start_write(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *res = __real_gnrc_pktbuf_start_write(pkt);
+
+    /* NULL for a NULL packet is not a failed allocation */
+    if (pkt != NULL) {
+        _allocated(res != NULL);
+    }
+    return res;
+}
+
+gnrc_pktsnip_t *bufstats_pktbuf_add_reserve(size_t size, size_t reserve,
+                                            gnrc_nettype_t type)
+{
+    gnrc_pktsnip_t *pkt;
+
+    if (reserve == 0) {
+        return __wrap_gnrc_pktbuf_add(NULL, NULL, size, type);
+    }
+    pkt = __real_gnrc_pktbuf_add(NULL, NULL, size + reserve, type);
+    if (pkt == NULL) {
+        return NULL;
+    }
+    /* frees the reserve again, in place */
+    gnrc_pktbuf_realloc_data(pkt, size);
+    return pkt;
+}
+
+void bufstats_sample(void)
+{
+    if (PKTBUF_USAGE) {
+        _pktbuf_sampled(_pktbuf_used(NULL));
+    }
+}
+
+void bufstats_pktbuf(bufstats_pktbuf_t *stats)
+{
+    unsigned state;
+
+    stats->used = _pktbuf_used(&stats->largest_free);
+    stats->size = PKTBUF_USAGE ? CONFIG_GNRC_PKTBUF_SIZE : 0;
+    _pktbuf_sampled(stats->used);
+    state = irq_disable();
+    stats->high_water = _pktbuf_high_water;
+    stats->alloc_failed = _pktbuf_failed;
+    irq_restore(state);
+}
+
+bool bufstats_queue(kernel_pid_t pid, bufstats_queue_t *stats)
+{
+    const thread_t *thread;
+    unsigned state;
+    bool found = false;
+
+    if (!pid_is_valid(pid)) {
+        return false;
+    }
+    state = irq_disable();
+    thread = thread_get(pid);
+    if ((thread != NULL) && thread_has_msg_queue(thread)) {
+        stats->size = thread->msg_queue.mask + 1;
+        stats->used = _queue_used(thread);
+        stats->high_water = _queue_high_water[pid];
+        stats->full = _queue_full[pid];
+        found = true;
+    }
+    irq_restore(state);
+    return found;
+}
+
+void bufstats_reset(void)
+{
+    uint32_t used = _pktbuf_used(NULL);
+    unsigned state = irq_disable();
+
+    _pktbuf_high_water = used;
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        const thread_t *thread = thread_get(pid);
+
+        _queue_high_water[pid] = ((thread != NULL) &&
+                                  thread_has_msg_queue(thread))
+                                 ? _queue_used(thread) : 0;
+    }
+    irq_restore(state);
+}
+
+void bufstats_print(void)
+{
+    bufstats_pktbuf_t pktbuf;
+
+    bufstats_pktbuf(&pktbuf);
+    puts("pktbuf_stats,Size,Used,High water,Largest free,Failed allocations");
+    printf("pktbuf_stats,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32
+           ",%" PRIu32 "\n", pktbuf.size, pktbuf.used, pktbuf.high_water,
+           pktbuf.largest_free, pktbuf.alloc_failed);
+    puts("msgq_stats,PID,Name,Size,Used,High water,Full");
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        bufstats_queue_t queue;
+        const char *name = "-";
+
+        if (!bufstats_queue(pid, &queue)) {
+            continue;
+        }
+#ifdef DEVELHELP
+        name = thread_get_name(thread_get(pid));
+#endif
+        printf("msgq_stats,%d,%s,%u,%u,%u,%" PRIu32 "\n", pid, name,
+               queue.size, queue.used, queue.high_water, queue.full);
+    }
+}
+
+int bufstats_cmd(int argc, char **argv)
+{
+    if ((argc >= 2) && (strcmp(argv[1], "reset") == 0)) {
+        bufstats_reset();
+    }
+    else if (argc >= 2) {
+        printf("usage: %s [reset]\n", argv[0]);
+        return 1;
+    }
+    bufstats_print();
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    bufstats Packet buffer and message queue statistics
+ * @{
+ *
+ * @file
+ * @brief       Occupancy, high-water marks and drops of the packet buffer
+ *              and of the message queues of all threads
+ *
+ * GNRC drops a packet silently when the packet buffer has no room for it or
+ * when the message queue of the next thread is full. The module wraps, at
+ * link time, the functions where this happens (gnrc_pktbuf_add(),
+ * gnrc_pktbuf_start_write(), msg_send(), msg_try_send(), msg_send_int()) to
+ * count the failures and update the queue high-water marks after every
+ * message. A queue high-water mark is the highest occupancy seen right after
+ * a message was queued, a lower bound for a queue whose receiver runs before
+ * the sender returns.
+ *
+ * Reading the packet buffer occupancy walks its free list, so it is not
+ * done for every allocation. Its high-water mark is the highest occupancy
+ * seen when an allocation failed, at each bufstats_pktbuf() (e.g. every
+ * statistics report) and at each bufstats_sample(): a lower bound, which
+ * misses the peaks shorter than the sampling period.
+ *
+ * The packet buffer occupancy needs gnrc_pktbuf_usage(), which the firmware
+ * builder appends to the static packet buffer of RIOT. Without it
+ * (BUFSTATS_PKTBUF_USAGE=0), only the failed allocations are counted.
+ *
+ * Output lines:
+ *
+ *     pktbuf_stats,Size,Used,High water,Largest free,Failed allocations
+ *     msgq_stats,PID,Name,Size,Used,High water,Full
+ *
+ * @}
+ */
+
+#ifndef BUFSTATS_H
+#define BUFSTATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sched.h"
+#include "net/gnrc/pktbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Report the packet buffer occupancy
+ */
+#ifndef CONFIG_BUFSTATS_PKTBUF_USAGE
+#define CONFIG_BUFSTATS_PKTBUF_USAGE    1
+#endif
+
+/**
+ * @brief   Packet buffer statistics, the sizes in bytes
+ */
+typedef struct {
+    uint32_t size;          /**< 0 if the occupancy is not known */
+    uint32_t used;
+    uint32_t high_water;
+    uint32_t largest_free;  /**< largest packet that can be allocated */
+    uint32_t alloc_failed;  /**< allocations that failed since boot */
+} bufstats_pktbuf_t;
+
+/**
+ * @brief   Message queue statistics of a thread, in messages
+ */
+typedef struct {
+    uint16_t size;
+    uint16_t used;
+    uint16_t high_water;
+    uint32_t full;          /**< messages not delivered since boot */
+} bufstats_queue_t;
+
+/**
+ * @brief   Read the packet buffer statistics, which also samples the
+ *          occupancy for the high-water mark
+ */
+void bufstats_pktbuf(bufstats_pktbuf_t *stats);
+
+/**
+ * @brief   Allocate a packet of @p size bytes only if @p reserve more bytes
+ *          stay free after it
+ *
+ * Tries to allocate size + reserve bytes, then gives the reserve back. This
+ * trial allocation is left out of the statistics: it failing is not a
+ * failed allocation.
+ *
+ * @return  the packet, NULL if there is no room for it and the reserve
+ */
+gnrc_pktsnip_t *bufstats_pktbuf_add_reserve(size_t size, size_t reserve,
+                                            gnrc_nettype_t type);
+
+/**
+ * @brief   Sample the packet buffer occupancy for the high-water mark
+ *
+ * For a finer high-water mark than the statistics reports give, from a
+ * thread and not from an interrupt: it takes the packet buffer mutex.
+ */
+void bufstats_sample(void);
+
+/**
+ * @brief   Read the message queue statistics of a thread
+ *
+ * @return  false if there is no such thread or it has no queue
+ */
+bool bufstats_queue(kernel_pid_t pid, bufstats_queue_t *stats);
+
+/**
+ * @brief   Restart the high-water marks from the current occupancy
+ */
+void bufstats_reset(void);
+
+/**
+ * @brief   Print the header and a line for the packet buffer and each queue
+ */
+void bufstats_print(void);
+
+/**
+ * @brief   Shell command: `bufstats [reset]`
+ */
+int bufstats_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUFSTATS_H */
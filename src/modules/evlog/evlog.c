@@ -0,0 +1,133 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     evlog
+ * @{
+ *
+ * @file
+ * @brief       Non-blocking event log with deferred formatting
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "kernel_defines.h"
+#include "mutex.h"
+#include "xtimer.h"
+
+#include "evlog.h"
+
+#define EVLOG_MASK  (CONFIG_EVLOG_QUEUE_SIZE - 1)
+
+#if (CONFIG_EVLOG_QUEUE_SIZE & EVLOG_MASK) != 0
+#error "CONFIG_EVLOG_QUEUE_SIZE must be a power of two"
+#endif
+
+static evlog_rec_t _ring[CONFIG_EVLOG_QUEUE_SIZE];
+/* free-running indexes, only written by the producers and the drain thread */
+static volatile unsigned _head;
+static volatile unsigned _tail;
+static volatile uint32_t _dropped;
+
+/* unlocked by producers to wake up the drain thread */
+static mutex_t _ready = MUTEX_INIT_LOCKED;
+static mutex_t _output = MUTEX_INIT;
+
+int evlog_write(evlog_print_t print, const void *args, size_t len)
+{
+    unsigned state;
+
+    /* also with NDEBUG: the copy below would overrun the record */
+    if (len > CONFIG_EVLOG_DATA_MAX) {
+        return -EINVAL;
+    }
+
+    state = irq_disable();
+    if ((_head - _tail) >= CONFIG_EVLOG_QUEUE_SIZE) {
+        _dropped++;
+        irq_restore(state);
+        return -ENOBUFS;
+    }
+    evlog_rec_t *rec = &_ring[_head & EVLOG_MASK];
+    rec->print = print;
+    rec->time = xtimer_now_usec();
+    rec->len = len;
+    memcpy(rec->data, args, len);
+    _head++;
+    irq_restore(state);
+
+    mutex_unlock(&_ready);
+    return 0;
+}
+
+static void _print_str(const evlog_rec_t *rec)
+{
+    const char *str;
+
+    memcpy(&str, rec->data, sizeof(str));
+    puts(str);
+}
+
+void evlog_puts(const char *str)
+{
+    evlog_write(_print_str, &str, sizeof(str));
+}
+
+uint32_t evlog_dropped(void)
+{
+    return _dropped;
+}
+
+void evlog_output_lock(void)
+{
+    mutex_lock(&_output);
+}
+
+void evlog_output_unlock(void)
+{
+    mutex_unlock(&_output);
+}
+
+static void *_drain_thread(void *arg)
+{
+    (void)arg;
+    uint32_t reported = 0;
+
+    while (1) {
+        mutex_lock(&_ready);
+        while (_tail != _head) {
+            evlog_rec_t *rec = &_ring[_tail & EVLOG_MASK];
+
+            evlog_output_lock();
+            if (IS_ACTIVE(CONFIG_EVLOG_PRINT_TIME)) {
+                printf("%" PRIu32 ";", rec->time);
+            }
+            rec->print(rec);
+            evlog_output_unlock();
+            /* the slot can only be reused once it has been printed */
+            _tail++;
+        }
+        if (_dropped != reported) {
+            reported = _dropped;
+            evlog_output_lock();
+            printf("error,log overflow,%" PRIu32 "\n", reported);
+            evlog_output_unlock();
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t evlog_init(char *stack, int stacksize, uint8_t priority)
+{
+    return thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _drain_thread, NULL, "evlog");
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    evlog Deferred event log
+ * @{
+ *
+ * @file
+ * @brief       Non-blocking event log with deferred formatting
+ *
+ * Hot paths call evlog_write() with a print callback and the raw arguments
+ * of the event. The record (callback, timestamp, arguments) is copied into a
+ * RAM ring with interrupts disabled for the duration of the copy, so the
+ * caller never waits for the UART. A low-priority drain thread later calls
+ * the callback of every record to format and print it. When the ring is
+ * full the record is dropped and counted, the drain thread reports the
+ * total number of dropped records as `error,log overflow,<n>`.
+ *
+ * Other threads printing directly (e.g. periodic statistics) should wrap
+ * their output in evlog_output_lock() / evlog_output_unlock() so that their
+ * lines are not interleaved with the ones of the drain thread.
+ *
+ * The drain thread holds that lock while it prints one record, so such a
+ * thread can wait for one line to go out on the UART, even with a higher
+ * priority than the drain thread. RIOT mutexes do not inherit priorities:
+ * threads between the two priorities (e.g. the shell) running meanwhile
+ * lengthen that wait.
+ *
+ * The arguments of an event are usually a struct, checked against the
+ * record size at build time with EVLOG_CHECK_SIZE().
+ *
+ * @}
+ */
+
+#ifndef EVLOG_H
+#define EVLOG_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of records in the ring, must be a power of two
+ */
+#ifndef CONFIG_EVLOG_QUEUE_SIZE
+#define CONFIG_EVLOG_QUEUE_SIZE     (32U)
+#endif
+
+/**
+ * @brief   Maximum size of the arguments of one record
+ */
+#ifndef CONFIG_EVLOG_DATA_MAX
+#define CONFIG_EVLOG_DATA_MAX       (20U)
+#endif
+
+/**
+ * @brief   Prefix every printed record with its timestamp (`<us>;`)
+ */
+#ifndef CONFIG_EVLOG_PRINT_TIME
+#define CONFIG_EVLOG_PRINT_TIME     0
+#endif
+
+/**
+ * @brief   Fail the build if arguments of type @p type do not fit a record
+ */
+#define EVLOG_CHECK_SIZE(type) \
+    static_assert(sizeof(type) <= CONFIG_EVLOG_DATA_MAX, \
+                  #type " does not fit an event log record")
+
+/**
+ * @brief   Record type
+ */
+typedef struct evlog_rec evlog_rec_t;
+
+/**
+ * @brief   Formats and prints one record, called from the drain thread
+ */
+typedef void (*evlog_print_t)(const evlog_rec_t *rec);
+
+/**
+ * @brief   An event waiting to be printed
+ */
+struct evlog_rec {
+    evlog_print_t print;                /**< formats the record */
+    uint32_t time;                      /**< xtimer_now_usec() at write */
+    uint8_t len;                        /**< size of data */
+    uint8_t data[CONFIG_EVLOG_DATA_MAX];    /**< arguments of the event */
+};
+
+/**
+ * @brief   Queue an event
+ *
+ * Can be called from any thread, never blocks. Arguments are copied, so
+ * pointers in @p args must stay valid until the record is printed (e.g.
+ * string literals or static buffers).
+ *
+ * @param[in] print     callback printing the record
+ * @param[in] args      arguments, copied into the record
+ * @param[in] len       size of @p args, at most CONFIG_EVLOG_DATA_MAX
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p len is above CONFIG_EVLOG_DATA_MAX, nothing is
+ *          queued
+ * @return  -ENOBUFS if the ring is full, the record is counted as dropped
+ */
+int evlog_write(evlog_print_t print, const void *args, size_t len);
+
+/**
+ * @brief   Queue a constant line
+ *
+ * @param[in] str   line without the trailing newline, must stay valid
+ */
+void evlog_puts(const char *str);
+
+/**
+ * @brief   Start the drain thread
+ *
+ * Events written before are kept and printed once the thread runs.
+ *
+ * @return  PID of the drain thread
+ */
+kernel_pid_t evlog_init(char *stack, int stacksize, uint8_t priority);
+
+/**
+ * @brief   Number of records dropped because the ring was full
+ */
+uint32_t evlog_dropped(void);
+
+/**
+ * @brief   Take the output lock before printing outside of evlog
+ *
+ * Waits until the drain thread has printed its current record.
+ */
+void evlog_output_lock(void);
+
+/**
+ * @brief   Release the output lock
+ */
+void evlog_output_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVLOG_H */
@@ -0,0 +1,142 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    payload_hdr Measurement header of the generated traffic
+ * @{
+ *
+ * @file
+ * @brief       Header at the start of the generated UDP payloads
+ *
+ * Lets the receiver measure loss, duplicates, reordering and one-way delay
+ * from the data alone. The header is little-endian and unaligned:
+ *
+ * | Offset | Size | Field                                     |
+ * |--------|------|-------------------------------------------|
+ * | 0      | 1    | magic, PAYLOAD_HDR_MAGIC                  |
+ * | 1      | 1    | generator, see payload_hdr_gen_t          |
+ * | 2      | 2    | node id                                   |
+ * | 4      | 4    | sequence number, per node and generator   |
+ * | 8      | 4    | send time, microseconds of the node clock |
+ *
+ * The rest of the payload is filler up to the configured packet size.
+ * tools/udp_collector.py parses it on the host.
+ *
+ * Several samples, each starting with its own header, can be sent in one
+ * aggregate payload:
+ *
+ * | Offset | Size | Field                                     |
+ * |--------|------|-------------------------------------------|
+ * | 0      | 1    | magic, PAYLOAD_AGG_MAGIC                  |
+ * | 1      | 1    | number of samples                         |
+ * | 2      | 1    | length of the first sample                |
+ * | 3      | n    | first sample                              |
+ * | 3 + n  | 1    | length of the second sample, ...          |
+ *
+ * payload_iter_next() walks the samples of both kinds of payloads.
+ *
+ * @}
+ */
+
+#ifndef PAYLOAD_HDR_H
+#define PAYLOAD_HDR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   First byte of a payload starting with the header
+ */
+#define PAYLOAD_HDR_MAGIC   (0xA7)
+
+/**
+ * @brief   Size of the encoded header
+ */
+#define PAYLOAD_HDR_LEN     (12U)
+
+/**
+ * @brief   First byte of an aggregate payload
+ */
+#define PAYLOAD_AGG_MAGIC   (0xA8)
+
+/**
+ * @brief   Size of the aggregate header (magic and sample count)
+ */
+#define PAYLOAD_AGG_HDR_LEN (2U)
+
+/**
+ * @brief   Generator (traffic flow) that emitted the packet
+ *
+ * Firmwares with more flows number the others from 2 on.
+ */
+typedef enum {
+    PAYLOAD_GEN_EXPONENTIAL = 0,
+    PAYLOAD_GEN_PERIODIC = 1,
+} payload_hdr_gen_t;
+
+/**
+ * @brief   Decoded header
+ */
+typedef struct {
+    uint8_t gen;            /**< payload_hdr_gen_t */
+    uint16_t node_id;       /**< sender */
+    uint32_t seq;           /**< sequence number of the generator */
+    uint32_t time;          /**< send time in microseconds, wraps */
+} payload_hdr_t;
+
+/**
+ * @brief   Iterator over the samples of a payload
+ */
+typedef struct {
+    const uint8_t *buf;     /**< payload */
+    size_t len;             /**< length of the payload */
+    size_t pos;             /**< offset of the next sample */
+    bool agg;               /**< aggregate payload */
+} payload_iter_t;
+
+/**
+ * @brief   Encode @p hdr at the start of @p buf
+ *
+ * @return  PAYLOAD_HDR_LEN
+ * @return  0 if @p len is too short, @p buf is untouched
+ */
+size_t payload_hdr_write(uint8_t *buf, size_t len, const payload_hdr_t *hdr);
+
+/**
+ * @brief   Decode the header at the start of @p buf
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p buf is too short or does not start with the magic
+ */
+int payload_hdr_read(const uint8_t *buf, size_t len, payload_hdr_t *hdr);
+
+/**
+ * @brief   Start iterating over the samples of a payload
+ *
+ * A payload that is not an aggregate is a single sample.
+ */
+void payload_iter_init(payload_iter_t *it, const uint8_t *buf, size_t len);
+
+/**
+ * @brief   Decode the header of the next sample
+ *
+ * @return  0 on success
+ * @return  -ENOENT after the last sample
+ * @return  -EINVAL if the sample has no header, or if the aggregate is
+ *          truncated which ends the iteration
+ */
+int payload_iter_next(payload_iter_t *it, payload_hdr_t *hdr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PAYLOAD_HDR_H */
@@ -0,0 +1,96 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     payload_hdr
+ * @{
+ *
+ * @file
+ * @brief       Header at the start of the generated UDP payloads
+ *
+ * @}
+ */
+
+#include <errno.h>
+
+#include "payload_hdr.h"
+
+static void _put_u16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = val;
+    buf[1] = val >> 8;
+}
+
+static void _put_u32(uint8_t *buf, uint32_t val)
+{
+    _put_u16(buf, val);
+    _put_u16(buf + 2, val >> 16);
+}
+
+static uint16_t _get_u16(const uint8_t *buf)
+{
+    return buf[0] | (buf[1] << 8);
+}
+
+static uint32_t _get_u32(const uint8_t *buf)
+{
+    return _get_u16(buf) | ((uint32_t)_get_u16(buf + 2) << 16);
+}
+
+size_t payload_hdr_write(uint8_t *buf, size_t len, const payload_hdr_t *hdr)
+{
+    if (len < PAYLOAD_HDR_LEN) {
+        return 0;
+    }
+    buf[0] = PAYLOAD_HDR_MAGIC;
+    buf[1] = hdr->gen;
+    _put_u16(buf + 2, hdr->node_id);
+    _put_u32(buf + 4, hdr->seq);
+    _put_u32(buf + 8, hdr->time);
+    return PAYLOAD_HDR_LEN;
+}
+
+int payload_hdr_read(const uint8_t *buf, size_t len, payload_hdr_t *hdr)
+{
+    if ((len < PAYLOAD_HDR_LEN) || (buf[0] != PAYLOAD_HDR_MAGIC)) {
+        return -EINVAL;
+    }
+    hdr->gen = buf[1];
+    hdr->node_id = _get_u16(buf + 2);
+    hdr->seq = _get_u32(buf + 4);
+    hdr->time = _get_u32(buf + 8);
+    return 0;
+}
+
+void payload_iter_init(payload_iter_t *it, const uint8_t *buf, size_t len)
+{
+    it->buf = buf;
+    it->len = len;
+    it->agg = (len >= PAYLOAD_AGG_HDR_LEN) && (buf[0] == PAYLOAD_AGG_MAGIC);
+    it->pos = it->agg ? PAYLOAD_AGG_HDR_LEN : 0;
+}
+
+int payload_iter_next(payload_iter_t *it, payload_hdr_t *hdr)
+{
+    size_t len;
+    int res;
+
+    if (it->pos >= it->len) {
+        return -ENOENT;
+    }
+    if (!it->agg) {
+        it->pos = it->len;
+        return payload_hdr_read(it->buf, it->len, hdr);
+    }
+    len = it->buf[it->pos];
+    if (it->pos + 1 + len > it->len) {
+        it->pos = it->len;
+        return -EINVAL;
+    }
+    res = payload_hdr_read(&it->buf[it->pos + 1], len, hdr);
+    it->pos += 1 + len;
+    return res;
+}
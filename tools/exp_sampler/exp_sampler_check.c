@@ -0,0 +1,187 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @file
+ * @brief       Host validation and benchmark of the integer exponential
+ *              sampler of the gnrc_networking firmware
+ *
+ * Feeds the same xorshift32 stream to the integer sampler and to the float
+ * implementation it replaces, `-(1 / rate) * logf(u)`, then reports:
+ *
+ * - the sample mean and variance against 1 / rate and 1 / rate^2,
+ * - the Kolmogorov-Smirnov distance to the exponential CDF, with the 1%
+ *   critical value for the number of samples,
+ * - the largest absolute error against -mean * ln(u) in double precision,
+ *   also relative to the mean, and the largest difference to the float
+ *   reference, which is itself limited by the 24 bit mantissa of u close
+ *   to 1,
+ * - the cost per sample of both implementations.
+ *
+ * The timings are taken on the host, which has an FPU: they only bound the
+ * integer sampler. Build the firmware with BENCH=1 for Cortex-M cycles.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC    1
+#endif
+
+#include "exp_sampler.h"
+
+#define HIST_BINS   (4096)
+
+static uint32_t _state = 2463534242UL;
+
+static uint32_t _xorshift32(void)
+{
+    _state ^= _state << 13;
+    _state ^= _state >> 17;
+    _state ^= _state << 5;
+    return _state;
+}
+
+static double _now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t _ticks(void)
+{
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static float _float_reference(float rate, uint32_t rnd)
+{
+    /* random_real() of RIOT: rnd / 2^32 in [0, 1) */
+    float u = rnd * (1.0f / 4294967296.0f);
+
+    return -(1 / rate) * logf(u);
+}
+
+static void _validate(uint32_t mean_us, unsigned long n)
+{
+    static unsigned long hist[HIST_BINS];
+    double sum = 0, sum2 = 0, max_abs = 0, max_float = 0;
+    double mean = mean_us;
+    /* histogram over [0, 16 * mean), finer than the KS resolution we need */
+    double bin_width = 16 * mean / HIST_BINS;
+    unsigned long overflow = 0;
+    float rate = 1e6f / mean_us;
+
+    for (unsigned long i = 0; i < n; i++) {
+        uint32_t rnd = _xorshift32();
+        double x = exp_sampler_sample_us(mean_us, rnd);
+        double ref = -mean * log((rnd ? rnd : 1) / 4294967296.0);
+        double diff = fabs(x - ref);
+        double fdiff = fabs(x - (double)_float_reference(rate, rnd ? rnd : 1)
+                                * 1e6);
+
+        sum += x;
+        sum2 += x * x;
+        if (fdiff > max_float) {
+            max_float = fdiff;
+        }
+        if (diff > max_abs) {
+            max_abs = diff;
+        }
+        unsigned long bin = x / bin_width;
+        if (bin < HIST_BINS) {
+            hist[bin]++;
+        }
+        else {
+            overflow++;
+        }
+    }
+
+    double avg = sum / n;
+    double var = sum2 / n - avg * avg;
+    double ks = 0;
+    unsigned long cumulative = 0;
+
+    for (unsigned i = 0; i < HIST_BINS; i++) {
+        cumulative += hist[i];
+        double empirical = (double)cumulative / n;
+        /* samples are rounded to integers: bin i holds the samples below
+         * ceil(edge), i.e. the real values below ceil(edge) - 0.5 */
+        double edge = ceil((i + 1) * bin_width) - 0.5;
+        double expected = 1 - exp(-edge / mean);
+        if (fabs(empirical - expected) > ks) {
+            ks = fabs(empirical - expected);
+        }
+        hist[i] = 0;
+    }
+
+    printf("mean_us=%" PRIu32 " samples=%lu\n", mean_us, n);
+    printf("  mean     %.1f us (expected %.1f, error %+.4f%%)\n",
+           avg, mean, 100 * (avg - mean) / mean);
+    printf("  stddev   %.1f us (expected %.1f, error %+.4f%%)\n",
+           sqrt(var), mean, 100 * (sqrt(var) - mean) / mean);
+    printf("  KS D     %.6f (1%% critical value %.6f), "
+           "%lu samples > 16 * mean\n", ks, 1.63 / sqrt(n), overflow);
+    printf("  vs exact max abs error %.1f us (%.2e * mean)\n",
+           max_abs, max_abs / mean);
+    printf("  vs float max abs diff %.1f us\n", max_float);
+}
+
+static void _bench(unsigned long n)
+{
+    volatile uint32_t sink = 0;
+    volatile float fsink = 0;
+    double start;
+    uint64_t ticks;
+
+    start = _now_ns();
+    ticks = _ticks();
+    for (unsigned long i = 0; i < n; i++) {
+        sink += exp_sampler_sample_us(4000000, _xorshift32());
+    }
+    ticks = _ticks() - ticks;
+    printf("integer sampler: %.2f ns/sample, %.1f cycles/sample\n",
+           (_now_ns() - start) / n, (double)ticks / n);
+
+    start = _now_ns();
+    ticks = _ticks();
+    for (unsigned long i = 0; i < n; i++) {
+        fsink += _float_reference(0.25f, _xorshift32());
+    }
+    ticks = _ticks() - ticks;
+    printf("float logf:      %.2f ns/sample, %.1f cycles/sample\n",
+           (_now_ns() - start) / n, (double)ticks / n);
+
+    start = _now_ns();
+    for (unsigned long i = 0; i < n; i++) {
+        sink += _xorshift32();
+    }
+    printf("xorshift32 only: %.2f ns/sample\n", (_now_ns() - start) / n);
+    (void)sink;
+    (void)fsink;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long n = (argc > 1) ? strtoul(argv[1], NULL, 0) : 10000000UL;
+    static const uint32_t means[] = { 1000, 100000, 4000000, 60000000 };
+
+    for (unsigned i = 0; i < sizeof(means) / sizeof(means[0]); i++) {
+        _validate(means[i], n);
+    }
+    _bench(n);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Regression checks of log_analyzer on small hand-written logs.
+
+    check.py [path of log_analyzer]
+"""
+
+import csv
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+ANALYZER = os.path.abspath(sys.argv[1] if len(sys.argv) > 1
+                           else os.path.join(os.path.dirname(__file__),
+                                             "log_analyzer"))
+
+NB_WINDOW = ("neighbor_window,00:11:22:33:44:55:66:77,4,3,2"
+             ",-80,-70,{mean},12.50,200,255,230.25,0.75"
+             ",1,2,1.50,0.25,900,1200,1000.00,100.00")
+
+
+def col_rows(path):
+    """Row count of a columnar table."""
+    with open(path, "rb") as f:
+        data = f.read()
+    ncols = struct.unpack_from("<I", data, 8)[0]
+    pos = 12
+    sizes = []
+    for _ in range(ncols):
+        kind = chr(data[pos])
+        sizes.append(8 if kind == "d" else 4)
+        pos += 2 + data[pos + 1]
+    rows = 0
+    while pos < len(data):
+        count = struct.unpack_from("<I", data, pos)[0]
+        rows += count
+        pos += 4 + count * sum(sizes)
+    return rows
+
+
+def analyze(logs):
+    """Runs the analyzer on {name: lines}, returns the output directory and
+    the summary rows by node."""
+    tmp = tempfile.mkdtemp()
+    paths = []
+    for name, lines in logs.items():
+        path = os.path.join(tmp, name + ".log")
+        with open(path, "w") as f:
+            f.write("\n".join(lines) + "\n")
+        paths.append(path)
+    out = os.path.join(tmp, "out")
+    subprocess.run([ANALYZER, "-j", "1", "-o", out] + paths, check=True,
+                   stderr=subprocess.DEVNULL)
+    with open(os.path.join(out, "summary.csv")) as f:
+        summary = {row["node"]: row for row in csv.DictReader(f)}
+    return out, summary
+
+
+def check(name, cond):
+    print("%s: %s" % ("ok" if cond else "FAIL", name))
+    return cond
+
+
+def main():
+    ok = True
+
+    out, _ = analyze({"m3-1": [NB_WINDOW.format(mean="-75.25"),
+                               NB_WINDOW.format(mean="-5"),
+                               NB_WINDOW.format(mean="-5.5"),
+                               NB_WINDOW.format(mean="5")]})
+    ok &= check("neighbor_window skips means without two decimals",
+                col_rows(os.path.join(out, "neighbor_window.col")) == 1)
+
+    nb = "neighbor_stats,00:11:22:33:44:55:66:%02x,1,100,10,10,-70,255,1000"
+    _, summary = analyze({"m3-2": [
+        "neighbor_stats,L2 address,fresh,etx,sent,received,rssi (dBm),lqi,"
+        "avg tx time (µs)",
+        nb % 1, nb % 2, nb % 3,
+        "stats,1,Layer 2,1,2,3,4,5,6,7",
+        nb % 1, nb % 2]})
+    ok &= check("neighbors counts the lines of the last report",
+                summary["m3-2"]["neighbors"] == "2")
+
+    dodag = ("rpl_stats_dodag,0,2001:db8::1,512,Router,2001:db8::/64"
+             ",8,20,10,0,1")
+    parent = "rpl_stats_parent,0,%s,256"
+    _, summary = analyze({"m3-3": [
+        dodag, parent % "fe80::a", parent % "fe80::b",
+        dodag, parent % "fe80::a", parent % "fe80::b",
+        dodag, parent % "fe80::b", parent % "fe80::a"]})
+    ok &= check("parent changes only follow the preferred parent",
+                summary["m3-3"]["parent changes"] == "1" and
+                summary["m3-3"]["parent"] == "fe80::b")
+
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,858 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @file
+ * @brief       Streaming analyzer of gnrc_networking serial logs
+ *
+ * Memory-maps every log, splits it into lines and fields without copying or
+ * allocating per line, and parses the `udp`, `stats`, `neighbor_stats`,
+ * `rpl_stats`, `rpl_status`, `rpl_stats_instance`, `rpl_stats_dodag`,
+ * `rpl_stats_parent`, `flow_stats`, `thread_stats`, `path_latency`,
+ * `pktbuf_stats`, `msgq_stats` and `neighbor_window` lines into per-node
+ * time series (one `path` row per non-empty histogram bucket). Files are
+ * spread over worker threads. Lines may carry the `<time>;<node>;` prefix
+ * of the IoT-LAB serial aggregator, otherwise the node is the file name and
+ * the time NaN.
+ *
+ * Output, in the directory given with -o:
+ *
+ * - `<table>.col` per line type, columnar: the magic `GNCOL1\0\0`, a u32
+ *   column count, per column a type byte (`u` u32, `i` i32, `d` f64, `s`
+ *   u32 index in dict.bin) with a u8 name length and the name, then row
+ *   groups of a u32 row count followed by every column as a contiguous
+ *   little-endian array. Every table starts with the `time` and `node`
+ *   columns, rows of one file are in file order.
+ * - `dict.bin`: the strings: `GNDICT1\0`, a u32 count, then per string a u16
+ *   length and the bytes.
+ * - `summary.csv` and `summary.col`: one row per node.
+ *
+ * The throughput (lines/s, MB/s) is printed on stderr.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr unsigned MAX_FIELDS = 32;
+constexpr size_t ROW_GROUP = 1 << 16;
+constexpr double NO_TIME = std::numeric_limits<double>::quiet_NaN();
+/* values of the failed `stats,0,-1,...` lines */
+constexpr uint32_t INVALID = UINT32_MAX;
+
+/* Strings shared by all workers, written to dict.bin */
+class Dictionary {
+public:
+    uint32_t intern(std::string_view s)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _ids.find(std::string(s));
+        if (it != _ids.end()) {
+            return it->second;
+        }
+        uint32_t id = _strings.size();
+        _strings.emplace_back(s);
+        _ids.emplace(_strings.back(), id);
+        return id;
+    }
+
+    const std::string &at(uint32_t id) const { return _strings[id]; }
+
+    bool write(const std::string &path) const
+    {
+        FILE *f = fopen(path.c_str(), "wb");
+        if (!f) {
+            return false;
+        }
+        uint32_t count = _strings.size();
+        fwrite("GNDICT1\0", 1, 8, f);
+        fwrite(&count, sizeof(count), 1, f);
+        for (const auto &s : _strings) {
+            uint16_t len = std::min<size_t>(s.size(), UINT16_MAX);
+            fwrite(&len, sizeof(len), 1, f);
+            fwrite(s.data(), 1, len, f);
+        }
+        return fclose(f) == 0;
+    }
+
+private:
+    std::mutex _lock;
+    std::unordered_map<std::string, uint32_t> _ids;
+    std::vector<std::string> _strings;
+};
+
+Dictionary dict;
+
+/* Per file cache in front of the dictionary, keys point into the mapping */
+class LocalDict {
+public:
+    uint32_t get(std::string_view s)
+    {
+        auto it = _cache.find(s);
+        if (it != _cache.end()) {
+            return it->second;
+        }
+        uint32_t id = dict.intern(s);
+        _cache.emplace(s, id);
+        return id;
+    }
+
+    void clear() { _cache.clear(); }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> _cache;
+};
+
+struct ColumnDef {
+    const char *name;
+    char type;
+};
+
+/* Columns in memory, one 32 bit or 64 bit slot per row */
+struct Chunk {
+    std::vector<std::vector<uint32_t>> u32;
+    std::vector<double> time;
+    size_t rows = 0;
+};
+
+/* Output file of a table, row groups are appended by the workers */
+class Table {
+public:
+    Table(const char *name, std::vector<ColumnDef> cols)
+        : name(name), cols(std::move(cols)) {}
+
+    bool open(const std::string &dir)
+    {
+        _file = fopen((dir + "/" + name + ".col").c_str(), "wb");
+        if (!_file) {
+            return false;
+        }
+        uint32_t ncols = cols.size() + 2;
+        fwrite("GNCOL1\0\0", 1, 8, _file);
+        fwrite(&ncols, sizeof(ncols), 1, _file);
+        _write_def({ "time", 'd' });
+        _write_def({ "node", 's' });
+        for (const auto &c : cols) {
+            _write_def(c);
+        }
+        return true;
+    }
+
+    void init(Chunk &chunk) const
+    {
+        chunk.u32.assign(cols.size() + 1, {});
+        for (auto &c : chunk.u32) {
+            c.reserve(ROW_GROUP);
+        }
+        chunk.time.reserve(ROW_GROUP);
+    }
+
+    void flush(Chunk &chunk)
+    {
+        if (chunk.rows == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            uint32_t rows = chunk.rows;
+            fwrite(&rows, sizeof(rows), 1, _file);
+            fwrite(chunk.time.data(), sizeof(double), rows, _file);
+            for (const auto &c : chunk.u32) {
+                fwrite(c.data(), sizeof(uint32_t), rows, _file);
+            }
+            total += rows;
+        }
+        chunk.time.clear();
+        for (auto &c : chunk.u32) {
+            c.clear();
+        }
+        chunk.rows = 0;
+    }
+
+    bool close() { return _file && (fclose(_file) == 0); }
+
+    const char *name;
+    std::vector<ColumnDef> cols;
+    uint64_t total = 0;
+
+private:
+    void _write_def(const ColumnDef &c)
+    {
+        uint8_t len = strlen(c.name);
+        fwrite(&c.type, 1, 1, _file);
+        fwrite(&len, 1, 1, _file);
+        fwrite(c.name, 1, len, _file);
+    }
+
+    FILE *_file = nullptr;
+    std::mutex _lock;
+};
+
+enum {
+    T_UDP, T_NETIF, T_NEIGHBOR, T_RPL, T_RPL_STATUS, T_RPL_INSTANCE,
+    T_RPL_DODAG, T_RPL_PARENT, T_FLOW, T_THREAD, T_PATH, T_PKTBUF,
+    T_MSGQ, T_NB_WINDOW, T_NUMOF
+};
+
+/* deque: tables hold a mutex and cannot move */
+std::deque<Table> tables;
+
+void init_tables()
+{
+    tables.emplace_back("udp", std::vector<ColumnDef>{
+        { "payload_size", 'u' }, { "dst", 's' }, { "port", 'u' } });
+    tables.emplace_back("netif", std::vector<ColumnDef>{
+        { "success", 'u' }, { "layer", 's' }, { "rx_packets", 'u' },
+        { "rx_bytes", 'u' }, { "tx_packets", 'u' }, { "tx_mcast_packets", 'u' },
+        { "tx_bytes", 'u' }, { "tx_succeeded", 'u' }, { "tx_errors", 'u' } });
+    tables.emplace_back("neighbor", std::vector<ColumnDef>{
+        { "l2addr", 's' }, { "freshness", 'i' }, { "etx_percent", 'u' },
+        { "sent", 'u' }, { "received", 'u' }, { "rssi", 'i' }, { "lqi", 'u' },
+        { "tx_time_avg", 'u' } });
+    tables.emplace_back("rpl", std::vector<ColumnDef>{
+        { "msg", 's' }, { "measure", 's' }, { "rx_ucast", 'u' },
+        { "tx_ucast", 'u' }, { "rx_mcast", 'u' }, { "tx_mcast", 'u' } });
+    tables.emplace_back("rpl_status", std::vector<ColumnDef>{
+        { "table", 's' }, { "index", 'i' }, { "state", 'i' } });
+    tables.emplace_back("rpl_instance", std::vector<ColumnDef>{
+        { "instance", 'i' }, { "iface", 'i' }, { "mop", 'i' }, { "ocp", 'i' },
+        { "min_hop_rank_inc", 'i' }, { "max_rank_inc", 'i' } });
+    tables.emplace_back("rpl_dodag", std::vector<ColumnDef>{
+        { "instance", 'i' }, { "dodag_id", 's' }, { "rank", 'i' },
+        { "role", 's' }, { "prefix_info", 's' }, { "dio_min", 'i' },
+        { "dio_interval_doubl", 'i' }, { "trickle_k", 'i' },
+        { "trickle_c", 'i' }, { "trickle_tc", 'u' } });
+    tables.emplace_back("rpl_parent", std::vector<ColumnDef>{
+        { "instance", 'i' }, { "addr", 's' }, { "rank", 'i' } });
+    tables.emplace_back("flow", std::vector<ColumnDef>{
+        { "flow", 'u' }, { "dist", 's' }, { "param", 's' },
+        { "payload_size", 'u' }, { "dst", 's' }, { "port", 'u' },
+        { "active", 'u' }, { "sent", 'u' }, { "bytes", 'u' },
+        { "dropped_stack", 'u' }, { "offered", 'u' },
+        { "dropped_src", 'u' } });
+    tables.emplace_back("thread", std::vector<ColumnDef>{
+        { "pid", 'u' }, { "name", 's' }, { "priority", 'u' },
+        { "cpu_permille", 'u' }, { "switches", 'u' }, { "stack_size", 'u' },
+        { "stack_used", 'u' } });
+    tables.emplace_back("path", std::vector<ColumnDef>{
+        { "stage", 's' }, { "packets", 'u' }, { "max_us", 'u' },
+        { "bucket", 'u' }, { "count", 'u' } });
+    tables.emplace_back("pktbuf", std::vector<ColumnDef>{
+        { "size", 'u' }, { "used", 'u' }, { "high_water", 'u' },
+        { "largest_free", 'u' }, { "alloc_failed", 'u' } });
+    tables.emplace_back("msgq", std::vector<ColumnDef>{
+        { "pid", 'u' }, { "name", 's' }, { "size", 'u' }, { "used", 'u' },
+        { "high_water", 'u' }, { "full", 'u' } });
+    /* means and variances in hundredths */
+    tables.emplace_back("neighbor_window", std::vector<ColumnDef>{
+        { "l2addr", 's' }, { "samples", 'u' }, { "sent", 'u' },
+        { "received", 'u' },
+        { "rssi_min", 'i' }, { "rssi_max", 'i' }, { "rssi_mean_centi", 'i' },
+        { "rssi_var_centi", 'u' },
+        { "lqi_min", 'i' }, { "lqi_max", 'i' }, { "lqi_mean_centi", 'i' },
+        { "lqi_var_centi", 'u' },
+        { "etx_min", 'i' }, { "etx_max", 'i' }, { "etx_mean_centi", 'i' },
+        { "etx_var_centi", 'u' },
+        { "tx_time_min", 'i' }, { "tx_time_max", 'i' },
+        { "tx_time_mean_centi", 'i' }, { "tx_time_var_centi", 'u' } });
+}
+
+/* Type of the previous line of a node, for the records that span lines */
+enum Prev : uint8_t {
+    P_OTHER,
+    P_NEIGHBOR,     /* neighbor_stats, the report goes on */
+    P_DODAG,        /* rpl_stats_dodag, a preferred parent follows */
+};
+
+/* Aggregate of one node */
+struct Summary {
+    uint64_t lines = 0;
+    uint64_t udp_packets = 0;
+    uint64_t udp_bytes = 0;
+    uint64_t errors = 0;
+    uint64_t parent_changes = 0;
+    double first_time = NO_TIME;
+    double last_time = NO_TIME;
+    uint32_t l2_tx_succeeded = 0;
+    uint32_t l2_tx_errors = 0;
+    uint32_t neighbors = 0;         /* neighbor lines of the last report */
+    int32_t rank = -1;
+    uint32_t parent = INVALID;      /* preferred parent */
+    uint32_t report_neighbors = 0;
+    Prev prev = P_OTHER;
+};
+
+void merge(Summary &into, const Summary &from)
+{
+    bool newer = std::isnan(into.last_time) || (from.last_time > into.last_time);
+
+    into.lines += from.lines;
+    into.udp_packets += from.udp_packets;
+    into.udp_bytes += from.udp_bytes;
+    into.errors += from.errors;
+    into.parent_changes += from.parent_changes;
+    if (std::isnan(into.first_time) || (from.first_time < into.first_time)) {
+        into.first_time = from.first_time;
+    }
+    if (newer) {
+        into.last_time = from.last_time;
+        into.l2_tx_succeeded = from.l2_tx_succeeded;
+        into.l2_tx_errors = from.l2_tx_errors;
+        into.neighbors = from.neighbors;
+        into.rank = from.rank;
+        into.parent = from.parent;
+    }
+}
+
+inline std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && ((s.front() == ' ') || (s.front() == '\t'))) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && ((s.back() == ' ') || (s.back() == '\r') ||
+                          (s.back() == '%'))) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+/* Splits without copying, the last field keeps any remaining commas */
+inline unsigned split(std::string_view line, std::string_view *fields)
+{
+    unsigned n = 0;
+
+    while (n < MAX_FIELDS - 1) {
+        size_t comma = line.find(',');
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        fields[n++] = trim(line.substr(0, comma));
+        line.remove_prefix(comma + 1);
+    }
+    fields[n++] = trim(line);
+    return n;
+}
+
+template <typename T>
+inline bool num(std::string_view s, T &value)
+{
+    auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+    return (res.ec == std::errc()) && (res.ptr == s.data() + s.size());
+}
+
+/* Parses fields[first..first+n) as integers into out, stored as u32 bits */
+inline bool nums(const std::string_view *fields, unsigned n, uint32_t *out)
+{
+    for (unsigned i = 0; i < n; i++) {
+        int64_t v;
+        if (!num(fields[i], v)) {
+            return false;
+        }
+        out[i] = static_cast<uint32_t>(v);
+    }
+    return true;
+}
+
+/* Parses a percentage with one decimal, as printed by the firmware, into
+ * permille */
+inline bool permille(std::string_view s, uint32_t &out)
+{
+    uint32_t whole, tenth = 0;
+    size_t dot = s.find('.');
+
+    if (!num(s.substr(0, dot), whole)) {
+        return false;
+    }
+    if ((dot != std::string_view::npos) &&
+        ((s.size() != dot + 2) || !num(s.substr(dot + 1), tenth))) {
+        return false;
+    }
+    out = whole * 10 + tenth;
+    return true;
+}
+
+/* Parses a number with two decimals, as printed by the firmware, into
+ * hundredths */
+inline bool centi(std::string_view s, uint32_t &out)
+{
+    bool neg = !s.empty() && (s[0] == '-');
+    uint32_t whole, hundredths;
+    size_t dot = s.find('.');
+
+    if (dot == std::string_view::npos) {
+        return false;
+    }
+    if (neg) {
+        s.remove_prefix(1);
+        dot--;
+    }
+    if ((s.size() != dot + 3) ||
+        !num(s.substr(0, dot), whole) || !num(s.substr(dot + 1), hundredths)) {
+        return false;
+    }
+    out = whole * 100 + hundredths;
+    if (neg) {
+        out = -out;
+    }
+    return true;
+}
+
+class Worker {
+public:
+    Worker()
+    {
+        _chunks.resize(T_NUMOF);
+        for (unsigned i = 0; i < T_NUMOF; i++) {
+            tables[i].init(_chunks[i]);
+        }
+    }
+
+    void run(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+
+        if ((fd < 0) || (fstat(fd, &st) < 0)) {
+            fprintf(stderr, "error,cannot open %s\n", path.c_str());
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return;
+        }
+        if (st.st_size == 0) {
+            ::close(fd);
+            return;
+        }
+        void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "error,cannot map %s\n", path.c_str());
+            return;
+        }
+        madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+        std::string_view base(path);
+        base.remove_prefix(std::min(base.size(), base.rfind('/') + 1));
+        base = base.substr(0, base.find('.'));
+        uint32_t file_node = dict.intern(base);
+
+        const char *p = static_cast<const char *>(map);
+        const char *end = p + st.st_size;
+        while (p < end) {
+            const char *nl = static_cast<const char *>(memchr(p, '\n', end - p));
+            if (!nl) {
+                nl = end;
+            }
+            _line(std::string_view(p, nl - p), file_node);
+            p = nl + 1;
+        }
+        bytes += st.st_size;
+
+        /* the cache keys point into the mapping */
+        for (unsigned i = 0; i < T_NUMOF; i++) {
+            tables[i].flush(_chunks[i]);
+        }
+        _local.clear();
+        munmap(map, st.st_size);
+    }
+
+    std::unordered_map<uint32_t, Summary> summaries;
+    uint64_t lines = 0;
+    uint64_t parsed = 0;
+    uint64_t bytes = 0;
+
+private:
+    void _line(std::string_view line, uint32_t node)
+    {
+        double time = NO_TIME;
+
+        lines++;
+        /* IoT-LAB serial aggregator: <time>;<node>;<line> */
+        if (!line.empty() && (line[0] >= '0') && (line[0] <= '9')) {
+            size_t semi = line.find(';');
+            size_t comma = line.find(',');
+            if ((semi != std::string_view::npos) && (semi < comma)) {
+                size_t semi2 = line.find(';', semi + 1);
+                if ((semi2 != std::string_view::npos) &&
+                    num(line.substr(0, semi), time)) {
+                    node = _local.get(line.substr(semi + 1, semi2 - semi - 1));
+                    line.remove_prefix(semi2 + 1);
+                }
+            }
+        }
+
+        std::string_view f[MAX_FIELDS];
+        unsigned n = split(line, f);
+        Summary &s = summaries[node];
+        uint32_t v[MAX_FIELDS];
+        const Prev prev = s.prev;
+
+        s.lines++;
+        s.prev = P_OTHER;
+        if (!std::isnan(time)) {
+            if (std::isnan(s.first_time)) {
+                s.first_time = time;
+            }
+            s.last_time = time;
+        }
+
+        const std::string_view type = f[0];
+        if (type == "udp") {
+            if ((n == 5) && num(f[1], v[0]) && num(f[3], v[2])) {
+                v[1] = _local.get(f[2]);
+                _add(T_UDP, time, node, v);
+                s.udp_packets++;
+                s.udp_bytes += v[0];
+            }
+        }
+        else if (type == "stats") {
+            if (n == 10) {
+                if (f[1] == "0") {
+                    std::fill(v, v + 9, INVALID);
+                    v[0] = 0;
+                    v[1] = _local.get("-");
+                    _add(T_NETIF, time, node, v);
+                }
+                else if (nums(f + 3, 7, v + 2)) {
+                    v[0] = 1;
+                    v[1] = _local.get(f[2]);
+                    _add(T_NETIF, time, node, v);
+                    if (f[2] == "Layer 2") {
+                        s.l2_tx_succeeded = v[7];
+                        s.l2_tx_errors = v[8];
+                    }
+                }
+            }
+        }
+        else if (type == "neighbor_stats") {
+            if ((n == 9) && nums(f + 3, 6, v + 2)) {
+                v[0] = _local.get(f[1]);
+                int32_t fresh = -1;
+                if ((f[2] != "STALE") && !num(f[2], fresh)) {
+                    return;
+                }
+                v[1] = static_cast<uint32_t>(fresh);
+                _add(T_NEIGHBOR, time, node, v);
+                /* a report is a run of neighbor lines, its header or any
+                 * other line ends it */
+                if (prev != P_NEIGHBOR) {
+                    s.report_neighbors = 0;
+                }
+                s.prev = P_NEIGHBOR;
+                s.neighbors = ++s.report_neighbors;
+            }
+        }
+        else if (type == "rpl_stats") {
+            if ((n == 7) && nums(f + 3, 4, v + 2)) {
+                v[0] = _local.get(f[1]);
+                v[1] = _local.get(f[2]);
+                _add(T_RPL, time, node, v);
+            }
+        }
+        else if (type == "rpl_status") {
+            if ((n == 4) && nums(f + 2, 2, v + 1)) {
+                v[0] = _local.get(f[1]);
+                _add(T_RPL_STATUS, time, node, v);
+            }
+        }
+        else if (type == "rpl_stats_instance") {
+            if ((n == 7) && nums(f + 1, 6, v)) {
+                _add(T_RPL_INSTANCE, time, node, v);
+            }
+        }
+        else if (type == "rpl_stats_dodag") {
+            if ((n == 11) && num(f[1], v[0]) && num(f[3], v[2]) &&
+                nums(f + 6, 5, v + 5)) {
+                v[1] = _local.get(f[2]);
+                v[3] = _local.get(f[4]);
+                v[4] = _local.get(f[5]);
+                _add(T_RPL_DODAG, time, node, v);
+                s.rank = v[2];
+                s.prev = P_DODAG;
+            }
+        }
+        else if (type == "rpl_stats_parent") {
+            if ((n == 4) && num(f[1], v[0]) && num(f[3], v[2])) {
+                v[1] = _local.get(f[2]);
+                _add(T_RPL_PARENT, time, node, v);
+                /* the preferred parent is listed first, after its DODAG */
+                if (prev == P_DODAG) {
+                    if ((s.parent != INVALID) && (s.parent != v[1])) {
+                        s.parent_changes++;
+                    }
+                    s.parent = v[1];
+                }
+            }
+        }
+        else if (type == "flow_stats") {
+            /* logs from before the admission control have no offered and
+             * dropped at source columns */
+            if (((n == 11) || (n == 13)) && num(f[1], v[0]) &&
+                num(f[4], v[3]) && nums(f + 6, n - 6, v + 5)) {
+                if (n == 11) {
+                    v[10] = 0;
+                    v[11] = 0;
+                }
+                v[1] = _local.get(f[2]);
+                v[2] = _local.get(f[3]);
+                v[4] = _local.get(f[5]);
+                _add(T_FLOW, time, node, v);
+            }
+        }
+        else if (type == "thread_stats") {
+            if ((n == 8) && num(f[1], v[0]) && num(f[3], v[2]) &&
+                permille(f[4], v[3]) && nums(f + 5, 3, v + 4)) {
+                v[1] = _local.get(f[2]);
+                _add(T_THREAD, time, node, v);
+            }
+        }
+        else if (type == "path_latency") {
+            uint32_t buckets[MAX_FIELDS];
+
+            if ((n > 4) && num(f[2], v[1]) && num(f[3], v[2]) &&
+                nums(f + 4, n - 4, buckets)) {
+                v[0] = _local.get(f[1]);
+                for (unsigned i = 0; i < n - 4; i++) {
+                    if (buckets[i] != 0) {
+                        v[3] = i;
+                        v[4] = buckets[i];
+                        _add(T_PATH, time, node, v);
+                    }
+                }
+            }
+        }
+        else if (type == "pktbuf_stats") {
+            if ((n == 6) && nums(f + 1, 5, v)) {
+                _add(T_PKTBUF, time, node, v);
+            }
+        }
+        else if (type == "msgq_stats") {
+            if ((n == 7) && num(f[1], v[0]) && nums(f + 3, 4, v + 2)) {
+                v[1] = _local.get(f[2]);
+                _add(T_MSGQ, time, node, v);
+            }
+        }
+        else if (type == "neighbor_window") {
+            bool ok = (n == 21) && nums(f + 2, 3, v + 1);
+
+            for (unsigned i = 5; ok && (i < n); i += 4) {
+                ok = nums(f + i, 2, v + i - 1) && centi(f[i + 2], v[i + 1]) &&
+                     centi(f[i + 3], v[i + 2]);
+            }
+            if (ok) {
+                v[0] = _local.get(f[1]);
+                _add(T_NB_WINDOW, time, node, v);
+            }
+        }
+        else if (type == "error") {
+            s.errors++;
+        }
+    }
+
+    void _add(unsigned table, double time, uint32_t node, const uint32_t *v)
+    {
+        Chunk &c = _chunks[table];
+
+        c.time.push_back(time);
+        c.u32[0].push_back(node);
+        for (size_t i = 1; i < c.u32.size(); i++) {
+            c.u32[i].push_back(v[i - 1]);
+        }
+        parsed++;
+        if (++c.rows == ROW_GROUP) {
+            tables[table].flush(c);
+        }
+    }
+
+    std::vector<Chunk> _chunks;
+    LocalDict _local;
+};
+
+bool write_summary(const std::string &dir,
+                   const std::unordered_map<uint32_t, Summary> &all)
+{
+    std::vector<std::pair<std::string, const Summary *>> rows;
+    for (const auto &e : all) {
+        rows.emplace_back(dict.at(e.first), &e.second);
+    }
+    std::sort(rows.begin(), rows.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    FILE *csv = fopen((dir + "/summary.csv").c_str(), "w");
+    if (!csv) {
+        return false;
+    }
+    fprintf(csv, "node,lines,udp packets,udp bytes,errors,first time,last time,"
+                 "l2 tx succeeded,l2 tx errors,neighbors,rank,parent,parent changes\n");
+    for (const auto &r : rows) {
+        const Summary &s = *r.second;
+        fprintf(csv, "%s,%llu,%llu,%llu,%llu,%.6f,%.6f,%u,%u,%u,%d,%s,%llu\n",
+                r.first.c_str(), (unsigned long long)s.lines,
+                (unsigned long long)s.udp_packets,
+                (unsigned long long)s.udp_bytes, (unsigned long long)s.errors,
+                s.first_time, s.last_time, s.l2_tx_succeeded, s.l2_tx_errors,
+                s.neighbors, s.rank,
+                (s.parent == INVALID) ? "" : dict.at(s.parent).c_str(),
+                (unsigned long long)s.parent_changes);
+    }
+    if (fclose(csv) != 0) {
+        return false;
+    }
+
+    /* `time` is the first time of the node */
+    Table table("summary", {
+        { "lines", 'u' }, { "udp_packets", 'u' }, { "udp_bytes", 'u' },
+        { "errors", 'u' }, { "duration_ms", 'u' }, { "l2_tx_succeeded", 'u' },
+        { "l2_tx_errors", 'u' }, { "neighbors", 'u' }, { "rank", 'i' },
+        { "parent", 's' }, { "parent_changes", 'u' } });
+    Chunk chunk;
+
+    if (!table.open(dir)) {
+        return false;
+    }
+    table.init(chunk);
+    for (const auto &r : rows) {
+        const Summary &s = *r.second;
+        double duration = (s.last_time - s.first_time) * 1000;
+        const uint32_t v[] = {
+            dict.intern(r.first), (uint32_t)s.lines, (uint32_t)s.udp_packets,
+            (uint32_t)s.udp_bytes, (uint32_t)s.errors,
+            std::isnan(duration) ? INVALID : (uint32_t)duration,
+            s.l2_tx_succeeded, s.l2_tx_errors, s.neighbors, (uint32_t)s.rank,
+            s.parent, (uint32_t)s.parent_changes,
+        };
+
+        chunk.time.push_back(s.first_time);
+        for (size_t i = 0; i < chunk.u32.size(); i++) {
+            chunk.u32[i].push_back(v[i]);
+        }
+        chunk.rows++;
+    }
+    table.flush(chunk);
+    return table.close();
+}
+
+void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-j threads] -o output_dir log...\n", name);
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string out;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:o:h")) != -1) {
+        switch (opt) {
+        case 'j':
+            threads = std::max(1, atoi(optarg));
+            break;
+        case 'o':
+            out = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (out.empty() || (optind >= argc)) {
+        usage(argv[0]);
+        return 1;
+    }
+    mkdir(out.c_str(), 0755);
+
+    init_tables();
+    for (auto &t : tables) {
+        if (!t.open(out)) {
+            fprintf(stderr, "error,cannot create %s/%s.col\n", out.c_str(), t.name);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> files(argv + optind, argv + argc);
+    /* biggest files first, so that the last one does not run alone */
+    std::vector<std::pair<off_t, size_t>> order;
+    for (size_t i = 0; i < files.size(); i++) {
+        struct stat st;
+        order.emplace_back((stat(files[i].c_str(), &st) == 0) ? st.st_size : 0, i);
+    }
+    std::sort(order.rbegin(), order.rend());
+    threads = std::min<size_t>(threads, files.size());
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next{0};
+    std::vector<Worker> workers(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            size_t i;
+            while ((i = next.fetch_add(1)) < order.size()) {
+                workers[t].run(files[order[i].second]);
+            }
+        });
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+
+    std::unordered_map<uint32_t, Summary> all;
+    uint64_t lines = 0, parsed = 0, bytes = 0;
+    for (const auto &w : workers) {
+        for (const auto &e : w.summaries) {
+            merge(all[e.first], e.second);
+        }
+        lines += w.lines;
+        parsed += w.parsed;
+        bytes += w.bytes;
+    }
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    bool ok = true;
+    for (auto &t : tables) {
+        ok &= t.close();
+    }
+    ok &= write_summary(out, all);
+    ok &= dict.write(out + "/dict.bin");
+    if (!ok) {
+        fprintf(stderr, "error,cannot write the output to %s\n", out.c_str());
+        return 1;
+    }
+
+    fprintf(stderr, "%zu files, %u threads, %llu lines (%llu records), %.1f MB "
+                    "in %.3f s: %.0f lines/s, %.1f MB/s\n",
+            files.size(), threads, (unsigned long long)lines,
+            (unsigned long long)parsed, bytes / 1e6, elapsed,
+            lines / elapsed, bytes / 1e6 / elapsed);
+    for (const auto &t : tables) {
+        fprintf(stderr, "  %-16s %llu rows\n", t.name, (unsigned long long)t.total);
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @file
+ * @brief       Synthetic gnrc_networking serial logs for log_analyzer
+ *
+ * Writes one log per node, `<dir>/m3-<n>.log`, with the IoT-LAB serial
+ * aggregator prefix and the exact line formats of the firmware: the
+ * headers, then every second one stats report (netif, neighbors, RPL) and
+ * the udp lines of an exponential generator.
+ */
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <getopt.h>
+#include <sys/stat.h>
+
+namespace {
+
+uint32_t state = 2463534242UL;
+
+uint32_t xorshift32()
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+double uniform()
+{
+    return (xorshift32() + 1.0) / 4294967297.0;
+}
+
+void headers(FILE *f, double t, const char *node)
+{
+    static const char *lines[] = {
+        "neighbor_stats,L2 address,fresh,etx,sent,received,rssi (dBm),lqi,avg tx time (µs)",
+        "rpl_stats,Packet Type,Measurement Type,RX unicast,TX unicast,RX multicast,TX multicast",
+        "stats,success,layer,rx packets,rx bytes,tx packets,tx multicast packets,tx bytes,tx succeeded,tx errors",
+        "rpl_status,Type of table,Index of the table,Table status",
+        "rpl_stats_instance,Instance ID,Interface ID,Mode of Operation,Objective Code Point,Min Hop Rank Increase,Max Rank Increase",
+        "rpl_stats_dodag,Instance ID,IPv6 Adress,Rank,Role,Prefix Information,Trickle Interval Size Min,Trickle Interval Size Max,Trickle Redundancy Constant,Trickle Counter,Trickle TC",
+        "rpl_stats_parent,Instance ID,IPv6 Adress,Rank,Lifetime",
+        "udp,payload size,destination address,destination port,payload",
+    };
+    for (const char *line : lines) {
+        fprintf(f, "%.6f;%s;%s\n", t, node, line);
+    }
+}
+
+void report(FILE *f, double t, const char *node, unsigned n, unsigned s)
+{
+    static const char *msgs[] = { "DIO", "DIS", "DAO", "DAO-ACK" };
+    unsigned neighbors = 3 + (n % 4);
+    unsigned parent = (n * 7 + s / 300) % 50;
+
+    fprintf(f, "%.6f;%s;stats,1,Layer 2,%u,%u,%u,%u,%u,%u,%u\n", t, node,
+            s * 12, s * 900, s * 9, s * 3, s * 700, s * 8, s / 10);
+    fprintf(f, "%.6f;%s;stats,1,IPv6,%u,%u,%u,%u,%u,%u,%u\n", t, node,
+            s * 6, s * 500, s * 5, s, s * 400, s * 5, 0u);
+    for (unsigned i = 0; i < neighbors; i++) {
+        char l2[32];
+        snprintf(l2, sizeof(l2), "12:34:56:78:9A:BC:%02X:%02X", (n + i) & 0xFF, i);
+        fprintf(f, "%.6f;%s;neighbor_stats,%-24s,%5u,%3u%%,%4u,%8u,%4i,%u,%7u\n",
+                t, node, l2, xorshift32() % 60, 100 + xorshift32() % 200,
+                s + i, s * 2 + i, -40 - (int)(xorshift32() % 50),
+                xorshift32() % 256, 2000 + xorshift32() % 3000);
+    }
+    for (const char *msg : msgs) {
+        fprintf(f, "%.6f;%s;rpl_stats,%s,packets,%10u,%-10u,%10u,%-10u\n", t,
+                node, msg, s, s / 2, s * 3, s / 4);
+        fprintf(f, "%.6f;%s;rpl_stats,%s,bytes,%10u,%-10u,%10u,%-10u\n", t,
+                node, msg, s * 80, s * 40, s * 240, s * 20);
+    }
+    fprintf(f, "%.6f;%s;rpl_status,instance,0,1\n", t, node);
+    fprintf(f, "%.6f;%s;rpl_status,parent,0,1\n", t, node);
+    fprintf(f, "%.6f;%s;rpl_stats_instance,0,6,2,1,256,0\n", t, node);
+    fprintf(f, "%.6f;%s;rpl_stats_dodag,0,2001:db8::1,%u,Router,on,8,20,10,%u,%u\n",
+            t, node, 256 + 256 * (1 + n % 5), xorshift32() % 10, s * 1000);
+    fprintf(f, "%.6f;%s;rpl_stats_parent,0,fe80::3432:4833:46d9:%04x,%u\n", t,
+            node, parent, 256 * (1 + n % 5));
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+    unsigned nodes = 100, seconds = 600;
+    double rate = 4;
+    std::string dir;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:r:o:")) != -1) {
+        switch (opt) {
+        case 'n':
+            nodes = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seconds = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rate = atof(optarg);
+            break;
+        case 'o':
+            dir = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n nodes] [-s seconds] "
+                            "[-r udp packets/s] -o dir\n", argv[0]);
+            return 1;
+        }
+    }
+    if (dir.empty() || (rate <= 0)) {
+        fprintf(stderr, "usage: %s [-n nodes] [-s seconds] "
+                        "[-r udp packets/s] -o dir\n", argv[0]);
+        return 1;
+    }
+    mkdir(dir.c_str(), 0755);
+
+    for (unsigned n = 1; n <= nodes; n++) {
+        char node[16];
+        std::string path = dir + "/m3-" + std::to_string(n) + ".log";
+        FILE *f = fopen(path.c_str(), "w");
+        double t = 1622040000.0 + n * 0.01;
+        double next_udp = t - std::log(uniform()) / rate;
+
+        if (!f) {
+            perror(path.c_str());
+            return 1;
+        }
+        snprintf(node, sizeof(node), "m3-%u", n);
+        headers(f, t, node);
+        for (unsigned s = 1; s <= seconds; s++) {
+            double now = t + s;
+
+            while (next_udp < now) {
+                fprintf(f, "%.6f;%s;udp,32,2001:db8::1,1337,%08" PRIX32 "%02X\n",
+                        next_udp, node, xorshift32(), xorshift32() & 0xFF);
+                next_udp -= std::log(uniform()) / rate;
+            }
+            report(f, now, node, n, s);
+        }
+        fclose(f);
+    }
+    return 0;
+}
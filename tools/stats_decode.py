@@ -0,0 +1,483 @@
+#!/usr/bin/env python3
+"""Decode the binary stats frames of the gnrc_networking firmware.
+
+With `STATS_FORMAT=binary`, the firmware writes its network statistics as
+CRC-checked frames (see src/gnrc_networking/stats.h) interleaved with the
+usual text lines. This tool reads a raw serial capture and writes it back as
+text, replacing every frame with exactly the CSV line(s) the firmware prints
+in `STATS_FORMAT=csv` mode. Text lines are passed through unchanged, frames
+with a bad CRC are treated as text so that no data is silently dropped.
+
+    stats_decode.py capture.bin > capture.csv
+    cat /dev/ttyUSB0 | stats_decode.py
+
+With --sizes, it prints instead the size of every snapshot (STATS_DELTA=1)
+in both formats, to measure what the binary output saves on the UART.
+--synthetic writes a reproducible capture of a typical node to compare with
+when no board is at hand:
+
+    stats_decode.py --synthetic 60 | stats_decode.py --sizes
+"""
+
+import argparse
+import binascii
+import ipaddress
+import random
+import struct
+import sys
+
+FRAME_SYNC = 0xFE
+FRAME_OVERHEAD = 5  # sync, type, len, crc16
+
+REC_NETIF = 1
+REC_NEIGHBOR = 2
+REC_RPL = 3
+REC_RPL_STATUS = 4
+REC_RPL_INSTANCE = 5
+REC_RPL_DODAG = 6
+REC_RPL_PARENT = 7
+REC_RPL_EVENT = 8
+REC_SNAPSHOT = 9
+REC_FLOW = 10
+REC_THREAD = 11
+REC_PATH = 12
+REC_PKTBUF = 13
+REC_MSGQ = 14
+REC_NB_WINDOW = 15
+
+# Packed little-endian layouts of the stats_rec_*_t structures
+LAYOUTS = {
+    REC_NETIF: struct.Struct("<BB7I"),
+    REC_NEIGHBOR: struct.Struct("<B8sBBHHHbBI"),
+    REC_RPL: struct.Struct("<B8I"),
+    REC_RPL_STATUS: struct.Struct("<BBB"),
+    REC_RPL_INSTANCE: struct.Struct("<BhBHHH"),
+    REC_RPL_DODAG: struct.Struct("<B16sHBBBBBHI"),
+    REC_RPL_PARENT: struct.Struct("<B16sH"),
+    REC_RPL_EVENT: struct.Struct("<BBHH16s16s"),
+    REC_SNAPSHOT: struct.Struct("<IB"),
+    REC_FLOW: struct.Struct("<BBBHH16s6I"),
+    # with the default CONFIG_STATS_THREAD_NAME_LEN
+    REC_THREAD: struct.Struct("<BB12sHIHH"),
+    # with the default CONFIG_STATS_PATH_BUCKETS
+    REC_PATH: struct.Struct("<BII20I"),
+    REC_PKTBUF: struct.Struct("<5I"),
+    REC_MSGQ: struct.Struct("<B12sHHHI"),
+    # min, max, mean and variance of RSSI, LQI, ETX and TX time
+    REC_NB_WINDOW: struct.Struct("<B8sHHH" + "iiiI" * 4),
+}
+
+# Removal records (STATS_DELTA=1): the identifying start of the record
+REMOVED_LAYOUTS = {
+    REC_NETIF: struct.Struct("<BB"),
+    REC_NEIGHBOR: struct.Struct("<B8s"),
+    REC_RPL: struct.Struct("<B"),
+    REC_RPL_STATUS: struct.Struct("<BB"),
+    REC_RPL_INSTANCE: struct.Struct("<B"),
+    REC_RPL_DODAG: struct.Struct("<B"),
+    REC_RPL_PARENT: struct.Struct("<B16s"),
+    REC_FLOW: struct.Struct("<B"),
+    REC_THREAD: struct.Struct("<B"),
+    REC_PATH: struct.Struct("<B"),
+    REC_PKTBUF: struct.Struct("<"),
+    REC_MSGQ: struct.Struct("<B"),
+}
+
+FAMILIES = {
+    REC_NETIF: "stats",
+    REC_NEIGHBOR: "neighbor_stats",
+    REC_RPL: "rpl_stats",
+    REC_RPL_STATUS: "rpl_status",
+    REC_RPL_INSTANCE: "rpl_stats_instance",
+    REC_RPL_DODAG: "rpl_stats_dodag",
+    REC_RPL_PARENT: "rpl_stats_parent",
+    REC_FLOW: "flow_stats",
+    REC_THREAD: "thread_stats",
+    REC_PATH: "path_latency",
+    REC_PKTBUF: "pktbuf_stats",
+    REC_MSGQ: "msgq_stats",
+}
+
+NETSTATS_MODULES = {0x01: "Layer 2", 0x02: "IPv6", 0xFF: "all"}
+RPL_MSGS = ["DIO", "DIS", "DAO", "DAO-ACK"]
+RPL_EVENTS = ["dodag", "parent", "rank"]
+FLOW_DISTS = ["exponential", "periodic", "onoff", "trace"]
+PATH_STAGES = ["gen", "udp", "ipv6", "sixlowpan", "tx_start", "tx_done",
+               "total"]
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, as crc16_ccitt_update(0xFFFF, ...) in RIOT."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def l2addr_str(addr, length):
+    return ":".join("%02X" % b for b in addr[:length])
+
+
+def ipv6_str(addr):
+    return str(ipaddress.IPv6Address(addr))
+
+
+def event_addr_str(addr):
+    return "-" if addr == bytes(16) else ipv6_str(addr)
+
+
+def centi_str(value):
+    return "%s%u.%02u" % ("-" if value < 0 else "", abs(value) // 100,
+                          abs(value) % 100)
+
+
+def format_removed(rtype, payload):
+    """Return the stats_removed line of a removal record."""
+    fields = REMOVED_LAYOUTS[rtype].unpack(payload)
+    line = "stats_removed," + FAMILIES[rtype]
+    if rtype == REC_NETIF:
+        line += "," + NETSTATS_MODULES.get(fields[1], "Unknown")
+    elif rtype == REC_NEIGHBOR:
+        line += "," + l2addr_str(fields[1], fields[0])
+    elif rtype == REC_RPL:
+        line += "," + (RPL_MSGS[fields[0]] if fields[0] < len(RPL_MSGS)
+                       else "Unknown")
+    elif rtype == REC_RPL_STATUS:
+        line += ",%s,%d" % ("parent" if fields[0] else "instance", fields[1])
+    elif rtype == REC_RPL_PARENT:
+        line += ",%d,%s" % (fields[0], ipv6_str(fields[1]))
+    elif rtype == REC_PATH:
+        line += "," + (PATH_STAGES[fields[0]] if fields[0] < len(PATH_STAGES)
+                       else "Unknown")
+    elif fields:
+        line += ",%d" % fields[0]
+    return [line]
+
+
+def format_record(rtype, payload):
+    """Return the CSV lines of one record, as printed by the firmware."""
+    if len(payload) != LAYOUTS[rtype].size:
+        return format_removed(rtype, payload)
+    fields = LAYOUTS[rtype].unpack(payload)
+
+    if rtype == REC_NETIF:
+        success, module = fields[:2]
+        if not success:
+            return ["stats,0,-1,-1,-1,-1,-1,-1,-1,-1"]
+        return ["stats,1,%s,%u,%u,%u,%u,%u,%u,%u"
+                % ((NETSTATS_MODULES.get(module, "Unknown"),) + fields[2:])]
+
+    if rtype == REC_NEIGHBOR:
+        (addr_len, addr, fresh, freshness, etx, tx_count, rx_count, rssi, lqi,
+         time_tx_avg) = fields
+        line = "neighbor_stats,%-24s," % l2addr_str(addr, addr_len)
+        line += ("%5u," % freshness) if fresh else "STALE,"
+        line += "%3u%%," % etx
+        line += "%4u,%8u," % (tx_count, rx_count)
+        line += "%4i," % rssi
+        line += "%u," % lqi
+        line += "%7u" % time_tx_avg
+        return [line]
+
+    if rtype == REC_RPL:
+        msg = fields[0]
+        name = RPL_MSGS[msg] if msg < len(RPL_MSGS) else "Unknown"
+        fmt = "rpl_stats,%s,%s,%10u,%-10u,%10u,%-10u"
+        return [fmt % ((name, "packets") + fields[1:5]),
+                fmt % ((name, "bytes") + fields[5:9])]
+
+    if rtype == REC_RPL_STATUS:
+        table, index, state = fields
+        return ["rpl_status,%s,%d,%d"
+                % ("parent" if table else "instance", index, state)]
+
+    if rtype == REC_RPL_INSTANCE:
+        return ["rpl_stats_instance,%d,%d,%d,%d,%d,%d" % fields]
+
+    if rtype == REC_RPL_DODAG:
+        (instance_id, dodag_id, rank, leaf, prefix_info, dio_min,
+         dio_interval_doubl, trickle_k, trickle_c, trickle_tc) = fields
+        return ["rpl_stats_dodag,%d,%s,%d,%s,%s,%d,%d,%d,%d,%u"
+                % (instance_id, ipv6_str(dodag_id), rank,
+                   "Leaf" if leaf else "Router", "on" if prefix_info else "off",
+                   1 << dio_min, dio_interval_doubl, trickle_k, trickle_c,
+                   trickle_tc)]
+
+    if rtype == REC_RPL_PARENT:
+        instance_id, addr, rank = fields
+        return ["rpl_stats_parent,%d,%s,%d" % (instance_id, ipv6_str(addr), rank)]
+
+    if rtype == REC_RPL_EVENT:
+        instance_id, event, old_rank, new_rank, old_addr, new_addr = fields
+        name = RPL_EVENTS[event] if event < len(RPL_EVENTS) else "Unknown"
+        if name == "rank":
+            old, new = str(old_rank), str(new_rank)
+        else:
+            old, new = event_addr_str(old_addr), event_addr_str(new_addr)
+        return ["rpl_event,%d,%s,%s,%s" % (instance_id, name, old, new)]
+
+    if rtype == REC_SNAPSHOT:
+        return ["stats_snapshot,%u,%d" % fields]
+
+    if rtype == REC_FLOW:
+        (flow_id, dist, active, size, port, addr, param, sent, nbytes,
+         dropped_stack, offered, dropped_src) = fields
+        return ["flow_stats,%d,%s,%u.%06u,%d,%s,%d,%d,%u,%u,%u,%u,%u"
+                % (flow_id, FLOW_DISTS[dist] if dist < len(FLOW_DISTS)
+                   else "Unknown", param // 1000000, param % 1000000, size,
+                   ipv6_str(addr), port, active, sent, nbytes, dropped_stack,
+                   offered, dropped_src)]
+
+    if rtype == REC_THREAD:
+        (pid, priority, name, cpu, switches, stack_size,
+         stack_used) = fields
+        return ["thread_stats,%d,%s,%d,%u.%u,%u,%u,%u"
+                % (pid, name.split(b"\0")[0].decode(errors="replace"),
+                   priority, cpu // 10, cpu % 10, switches, stack_size,
+                   stack_used)]
+
+    if rtype == REC_PATH:
+        stage, count, max_us = fields[:3]
+        return ["path_latency,%s,%u,%u,%s"
+                % (PATH_STAGES[stage] if stage < len(PATH_STAGES)
+                   else "Unknown", count, max_us,
+                   ",".join(str(n) for n in fields[3:]))]
+
+    if rtype == REC_PKTBUF:
+        return ["pktbuf_stats,%u,%u,%u,%u,%u" % fields]
+
+    if rtype == REC_MSGQ:
+        pid, name, size, used, high_water, full = fields
+        name = name.split(b"\0")[0].decode(errors="replace") or "-"
+        return ["msgq_stats,%d,%s,%u,%u,%u,%u"
+                % (pid, name, size, used, high_water, full)]
+
+    if rtype == REC_NB_WINDOW:
+        addr_len, addr, samples, tx_count, rx_count = fields[:5]
+        line = "neighbor_window,%s,%u,%u,%u" % (l2addr_str(addr, addr_len),
+                                               samples, tx_count, rx_count)
+        for i in range(5, len(fields), 4):
+            vmin, vmax, mean, var = fields[i:i + 4]
+            line += ",%d,%d,%s,%s" % (vmin, vmax, centi_str(mean),
+                                      centi_str(var))
+        return [line]
+
+    raise ValueError("unknown record type %d" % rtype)
+
+
+def try_frame(buf, pos):
+    """Parse a frame at buf[pos].
+
+    Returns (type, payload, end) for a valid frame, None if buf[pos] does not
+    start a valid frame, or "short" if more data is needed to decide.
+    """
+    if len(buf) - pos < 3:
+        return "short"
+    rtype, length = buf[pos + 1], buf[pos + 2]
+    layout = LAYOUTS.get(rtype)
+    removed = REMOVED_LAYOUTS.get(rtype)
+    if layout is None or (layout.size != length and
+                          (removed is None or removed.size != length)):
+        return None
+    end = pos + length + FRAME_OVERHEAD
+    if len(buf) < end:
+        return "short"
+    crc = buf[end - 2] | (buf[end - 1] << 8)
+    if crc16(bytes(buf[pos + 1:end - 2])) != crc:
+        return None
+    return rtype, bytes(buf[pos + 3:end - 2]), end
+
+
+class Decoder:
+    """Incremental decoder: feed() raw bytes, get text lines back.
+
+    on_record(rtype, frame_len, lines), if given, is called for every frame
+    with its size on the wire and the CSV lines it stands for.
+    """
+
+    def __init__(self, stats=None, on_record=None):
+        self.buf = bytearray()
+        self.text = bytearray()
+        self.stats = stats if stats is not None else {}
+        self.on_record = on_record
+
+    def _count(self, key, n=1):
+        self.stats[key] = self.stats.get(key, 0) + n
+
+    def feed(self, data, final=False):
+        self.buf += data
+        out = []
+        pos = 0
+        buf = self.buf
+        while pos < len(buf):
+            if buf[pos] == FRAME_SYNC:
+                res = try_frame(buf, pos)
+                if res == "short" and not final:
+                    break
+                if isinstance(res, tuple):
+                    rtype, payload, pos = res
+                    lines = format_record(rtype, payload)
+                    self._count("frames")
+                    self._count("frame_bytes", len(payload) + FRAME_OVERHEAD)
+                    if self.on_record is not None:
+                        self.on_record(rtype, len(payload) + FRAME_OVERHEAD,
+                                       lines)
+                    out.extend(lines)
+                    continue
+                self._count("bad_frames")
+            nl = pos
+            while nl < len(buf) and buf[nl] not in (FRAME_SYNC, 0x0A):
+                nl += 1
+            self.text += buf[pos:nl]
+            if nl < len(buf) and buf[nl] == 0x0A:
+                out.append(self.text.decode("utf-8", "replace"))
+                self._count("text_lines")
+                self.text = bytearray()
+                nl += 1
+            elif nl < len(buf) and nl == pos:
+                # a sync byte that did not start a valid frame
+                self.text.append(buf[nl])
+                nl += 1
+            pos = nl
+        del self.buf[:pos]
+        if final and self.text:
+            out.append(self.text.decode("utf-8", "replace"))
+            self.text = bytearray()
+        return out
+
+
+class Sizes:
+    """Bytes of every snapshot as frames and as the CSV lines they replace."""
+
+    HEADER = "sizes,Snapshot,Records,Binary (bytes),CSV (bytes),Saved (%)"
+
+    def __init__(self, out):
+        self.out = out
+        self.snapshot = None
+        self.total = [0, 0, 0]
+        self.current = [0, 0, 0]
+        print(self.HEADER, file=out)
+
+    def _line(self, name, counts):
+        records, binary, csv = counts
+        saved = 100.0 * (csv - binary) / csv if csv else 0.0
+        print("sizes,%s,%u,%u,%u,%.1f" % (name, records, binary, csv, saved),
+              file=self.out)
+
+    def _end_snapshot(self):
+        if self.current[0]:
+            self._line("-" if self.snapshot is None else self.snapshot,
+                       self.current)
+        self.current = [0, 0, 0]
+
+    def record(self, rtype, frame_len, lines):
+        if rtype == REC_SNAPSHOT:
+            self._end_snapshot()
+            # stats_snapshot,<seq>,<keyframe>
+            self.snapshot = lines[0].split(",")[1]
+        csv = sum(len(line.encode()) + 1 for line in lines)
+        for counts in (self.current, self.total):
+            counts[0] += 1
+            counts[1] += frame_len
+            counts[2] += csv
+
+    def close(self):
+        self._end_snapshot()
+        self._line("total", self.total)
+
+
+def frame(rtype, *fields):
+    """Encode one record as the firmware does."""
+    payload = LAYOUTS[rtype].pack(*fields)
+    body = bytes([rtype, len(payload)]) + payload
+    return bytes([FRAME_SYNC]) + body + struct.pack("<H", crc16(body))
+
+
+def synthetic(snapshots, seed=1):
+    """Capture of a node reporting every second: one 802.15.4 interface,
+    6 neighbors, a RPL DODAG with one parent, the two boot flows and the
+    buffer occupancy, as with STATS_DELTA=1 and a keyframe every report so
+    that every snapshot is complete."""
+    rng = random.Random(seed)
+    out = bytearray()
+    neighbors = [bytes([0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, i])
+                 for i in range(6)]
+    dodag = bytes.fromhex("2001066000003f00000000000000a3b2")
+    parent = bytes.fromhex("fe80000000000000123456789abcde00")
+    server = bytes.fromhex("2001066000003f00000000000000a3b2")
+    for seq in range(snapshots):
+        t = seq + 1
+        out += frame(REC_SNAPSHOT, seq, 1)
+        for module, scale in ((0x01, 60), (0x02, 40)):
+            out += frame(REC_NETIF, 1, module, t * scale, t * scale * 48,
+                         t * scale // 2, t * scale * 40, t * scale // 20,
+                         t * scale // 2, t * scale // 50)
+        for i, addr in enumerate(neighbors):
+            out += frame(REC_NEIGHBOR, 8, addr, 1, rng.randrange(1, 256),
+                         rng.randrange(100, 300), t * (10 + i),
+                         t * (30 + i), -rng.randrange(40, 90),
+                         rng.randrange(0xC0, 0x100), rng.randrange(800, 9000))
+        for msg in range(len(RPL_MSGS)):
+            out += frame(REC_RPL, msg, t * 3, t, t * 2, 0, t * 300, t * 100,
+                         t * 200, 0)
+        out += frame(REC_RPL_STATUS, 0, 0, 1)
+        for i in range(3):
+            out += frame(REC_RPL_STATUS, 1, i, int(i == 0))
+        out += frame(REC_RPL_INSTANCE, 0, 1, 1, 256, 256, 0)
+        out += frame(REC_RPL_DODAG, 0, dodag, 512, 0, 1, 12, 8, 10, 1,
+                     rng.randrange(1, 60))
+        out += frame(REC_RPL_PARENT, 0, parent, 256)
+        for flow in range(2):
+            out += frame(REC_FLOW, flow, flow, 1, 20, 1234, server,
+                         [250000, 1000000][flow], t * [4, 1][flow],
+                         t * [80, 20][flow], 0, t * [4, 1][flow], 0)
+        out += frame(REC_PKTBUF, 6144, rng.randrange(0, 600),
+                     rng.randrange(600, 1500), 6144 - 600, 0)
+        for pid, name, size in ((3, b"ipv6", 8), (4, b"udp", 8),
+                                (5, b"6lo", 8), (6, b"nrf802154", 16),
+                                (7, b"RPL", 8)):
+            out += frame(REC_MSGQ, pid, name, size, 0, rng.randrange(0, 4), 0)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", default="-",
+                        help="raw serial capture (default: stdin)")
+    parser.add_argument("-o", "--output", default="-",
+                        help="decoded text output (default: stdout)")
+    parser.add_argument("-s", "--summary", action="store_true",
+                        help="print frame counters to stderr when done")
+    parser.add_argument("--sizes", action="store_true",
+                        help="print the binary and CSV bytes of every "
+                             "snapshot instead of the decoded text")
+    parser.add_argument("--synthetic", type=int, metavar="N",
+                        help="write a capture of N synthetic snapshots "
+                             "and exit")
+    args = parser.parse_args()
+
+    if args.synthetic is not None:
+        out = sys.stdout.buffer if args.output == "-" \
+            else open(args.output, "wb")
+        with out:
+            out.write(synthetic(args.synthetic))
+        return
+
+    src = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+    dst = sys.stdout if args.output == "-" else open(args.output, "w")
+    sizes = Sizes(dst) if args.sizes else None
+    decoder = Decoder(on_record=sizes.record if sizes else None)
+    with src, dst:
+        while True:
+            chunk = src.read1(65536) if hasattr(src, "read1") else src.read(65536)
+            lines = decoder.feed(chunk, final=not chunk)
+            for line in lines if sizes is None else []:
+                dst.write(line + "\n")
+            if not chunk:
+                break
+        if sizes is not None:
+            sizes.close()
+    if args.summary:
+        for key, value in sorted(decoder.stats.items()):
+            print("%s: %d" % (key, value), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
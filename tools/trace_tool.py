@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Build the traces replayed by the gnrc_networking trace generator.
+
+A trace is the magic `GNT1` followed by two unsigned LEB128 varints per
+packet: the time since the previous packet in microseconds and the
+zigzag-encoded change of the payload size (see
+src/gnrc_networking/trace.h).
+
+    # CSV of `delta_us,size` lines
+    trace_tool.py encode packets.csv trace.bin
+    # CSV of `time_s,size` lines, e.g. a capture exported with tshark
+    trace_tool.py encode --absolute capture.csv trace.bin
+    # the udp,... lines of a recorded gnrc_networking log
+    trace_tool.py encode --log m3-12.log trace.bin
+
+    trace_tool.py decode trace.bin          # back to delta_us,size lines
+    trace_tool.py shell trace.bin > upload  # `trace` shell commands
+
+Link a trace into the firmware with `make TRACE_FILE=trace.bin`, or send the
+output of `shell` to the node's shell to upload it.
+"""
+
+import argparse
+import sys
+
+MAGIC = b"GNT1"
+
+# Bytes per `trace add` line, keeps the line below the shell buffer size
+SHELL_CHUNK = 48
+
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(data) or shift > 28:
+            raise ValueError("truncated record at offset %d" % pos)
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def encode(packets):
+    """packets: iterable of (delta_us, size)."""
+    out = bytearray(MAGIC)
+    prev = 0
+    for delta, size in packets:
+        if not 0 <= delta < 1 << 32 or not 0 <= size < 1 << 16:
+            raise ValueError("packet out of range: %d us, %d bytes"
+                             % (delta, size))
+        diff = size - prev
+        out += varint(delta)
+        out += varint((diff << 1) ^ -1 if diff < 0 else diff << 1)
+        prev = size
+    return bytes(out)
+
+
+def decode(data):
+    if data[:len(MAGIC)] != MAGIC:
+        raise ValueError("not a trace")
+    pos = len(MAGIC)
+    size = 0
+    while pos < len(data):
+        delta, pos = read_varint(data, pos)
+        zigzag, pos = read_varint(data, pos)
+        size += (zigzag >> 1) ^ -(zigzag & 1)
+        yield delta, size
+
+
+def _fields(path, sep):
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            yield line.split(sep)
+
+
+def relative(packets):
+    """(time_us, size) to (delta_us, size). The delta of the first packet is
+    its time after the last one when the trace loops: the mean inter-arrival
+    time, so that the loop keeps the rate of the trace."""
+    packets = list(packets)
+    period = 0
+    if len(packets) > 1:
+        period = round((packets[-1][0] - packets[0][0]) / (len(packets) - 1))
+    last = None
+    for time_us, size in packets:
+        yield (period if last is None else time_us - last), size
+        last = time_us
+
+
+def read_csv(path, absolute):
+    packets = []
+    for fields in _fields(path, ","):
+        try:
+            first, size = float(fields[0]), int(fields[1])
+        except (ValueError, IndexError):
+            continue                # header
+        if absolute:
+            packets.append((round(first * 1e6), size))
+        else:
+            packets.append((int(first), size))
+    return relative(packets) if absolute else packets
+
+
+def read_log(path, node):
+    """udp,... lines of a log with the IoT-LAB `time;node;` prefix."""
+    packets = []
+    for fields in _fields(path, ";"):
+        if len(fields) < 3 or (node and fields[1] != node):
+            continue
+        line = fields[2].split(",")
+        if line[0] != "udp":
+            continue
+        try:
+            time_us, size = round(float(fields[0]) * 1e6), int(line[1])
+        except (ValueError, IndexError):
+            continue                # header
+        packets.append((time_us, size))
+    return relative(packets)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    enc = sub.add_parser("encode", help="build a trace")
+    enc.add_argument("input")
+    enc.add_argument("output")
+    src = enc.add_mutually_exclusive_group()
+    src.add_argument("--absolute", action="store_true",
+                     help="the first column is a time in seconds")
+    src.add_argument("--log", action="store_true",
+                     help="read the udp,... lines of a log")
+    enc.add_argument("--node", help="with --log, only this node")
+    dec = sub.add_parser("decode", help="print a trace as CSV")
+    dec.add_argument("input")
+    shell = sub.add_parser("shell", help="print the upload commands")
+    shell.add_argument("input")
+    args = parser.parse_args()
+
+    if args.cmd == "encode":
+        if args.log:
+            packets = list(read_log(args.input, args.node))
+        else:
+            packets = list(read_csv(args.input, args.absolute))
+        if not packets:
+            sys.exit("no packet in %s" % args.input)
+        data = encode(packets)
+        with open(args.output, "wb") as f:
+            f.write(data)
+        duration = sum(d for d, _ in packets)
+        print("%d packets, %d payload bytes over %.3f s, %d trace bytes "
+              "(%.2f per packet)" % (len(packets), sum(s for _, s in packets),
+                                     duration / 1e6, len(data),
+                                     (len(data) - len(MAGIC)) / len(packets)),
+              file=sys.stderr)
+        return
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if args.cmd == "decode":
+        print("delta_us,size")
+        for delta, size in decode(data):
+            print("%d,%d" % (delta, size))
+        return
+
+    sum(1 for _ in decode(data))    # check before printing anything
+    print("trace clear")
+    for pos in range(0, len(data), SHELL_CHUNK):
+        print("trace add %s" % data[pos:pos + SHELL_CHUNK].hex())
+    print("trace done")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""Collect the UDP traffic of the gnrc_networking firmware.
+
+With `PAYLOAD_HEADER=1`, every payload starts with a node id, a sequence
+number per node and generator and the send time of the node clock (see
+src/modules/payload_hdr/include/payload_hdr.h). This tool listens on the
+server port of the nodes and keeps, per node and generator, in constant
+memory:
+
+- received, duplicate and reordered packets, losses and the PDR over the
+  sequence numbers seen so far, summed over the restarts of the node,
+- a histogram of the one-way delay and the RFC 3550 interarrival jitter.
+
+The node clocks are not synchronised with the host, so the delay is relative:
+the difference between receive and send time, minus the smallest difference
+seen for that node. This removes the clock offset, not the drift.
+
+With `AGGREGATE=1`, a datagram carries several samples, each with its own
+header; they are counted as packets and the datagrams they came in are
+counted separately.
+
+    udp_collector.py --port 1337 --interval 10
+"""
+
+import argparse
+import ipaddress
+import signal
+import socket
+import struct
+import sys
+import time
+
+HDR = struct.Struct("<BBHII")
+HDR_MAGIC = 0xA7
+AGG_MAGIC = 0xA8
+GENERATORS = ["exponential", "periodic"]
+
+# Sequence numbers within this distance behind the highest one are checked
+# for duplicates and counted as reordered. Further behind, the node is taken
+# to have restarted its sequence numbers.
+DUP_WINDOW = 4096
+
+
+class Flow:
+    """Streaming statistics of one node and generator."""
+
+    def __init__(self, source, bin_us, bins):
+        self.source = source
+        self.received = 0
+        self.datagrams = 0
+        self.duplicates = 0
+        self.reordered = 0
+        self.first_seq = None
+        self.max_seq = None
+        self.span = 0  # sequence numbers of the runs before the last reset
+        self.window = 0  # bit i: max_seq - i was received
+        self.bin_us = bin_us
+        self.hist = [0] * (bins + 1)  # last bin: overflow
+        self.min_offset = None
+        self.tx_high = 0  # unwrapped send time
+        self.last_transit = None
+        self.jitter = 0.0
+        self.max_delay = 0
+
+    def _unwrap_tx(self, tx):
+        if self.received == 0:
+            self.tx_high = tx
+        else:
+            delta = (tx - self.tx_high) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            self.tx_high += delta
+        return self.tx_high
+
+    def _restart(self, seq, tx):
+        """Starts a new run of sequence numbers and of the node clock."""
+        self.span += self.max_seq - self.first_seq + 1
+        self.first_seq = self.max_seq = seq
+        self.window = 1
+        self.tx_high = tx
+        self.min_offset = None
+        self.last_transit = None
+
+    def add(self, seq, tx, rx_us):
+        if self.max_seq is None:
+            self.first_seq = self.max_seq = seq
+            self.window = 1
+        elif seq > self.max_seq:
+            shift = seq - self.max_seq
+            if shift >= DUP_WINDOW:
+                self.window = 1
+            else:
+                self.window = (((self.window << shift) | 1) &
+                               ((1 << DUP_WINDOW) - 1))
+            self.max_seq = seq
+        elif self.max_seq - seq >= DUP_WINDOW:
+            self._restart(seq, tx)
+        else:
+            behind = self.max_seq - seq
+            if self.window & (1 << behind):
+                self.duplicates += 1
+                return
+            self.window |= 1 << behind
+            self.reordered += 1
+            if seq < self.first_seq:
+                self.first_seq = seq
+        self.received += 1
+
+        # send times of reordered packets go back, keep them for the delay
+        # but do not move the unwrap reference backwards
+        high = self.tx_high
+        tx_us = self._unwrap_tx(tx)
+        if tx_us < high:
+            self.tx_high = high
+        transit = rx_us - tx_us
+        if self.last_transit is not None:
+            self.jitter += (abs(transit - self.last_transit) - self.jitter) / 16
+        self.last_transit = transit
+        if (self.min_offset is None) or (transit < self.min_offset):
+            # the histogram is relative to the smallest transit time: shift
+            # it when a smaller one shows up (rare after the first packets)
+            if self.min_offset is not None:
+                self._shift((self.min_offset - transit) // self.bin_us)
+                self.max_delay += self.min_offset - transit
+            self.min_offset = transit
+        delay = transit - self.min_offset
+        self.max_delay = max(self.max_delay, delay)
+        self.hist[min(delay // self.bin_us, len(self.hist) - 1)] += 1
+
+    def _shift(self, nbins):
+        if nbins <= 0:
+            return
+        last = len(self.hist) - 1
+        hist = [0] * len(self.hist)
+        for i, count in enumerate(self.hist):
+            hist[min(i + nbins, last)] += count
+        self.hist = hist
+
+    @property
+    def expected(self):
+        if self.max_seq is None:
+            return 0
+        return self.span + self.max_seq - self.first_seq + 1
+
+    @property
+    def lost(self):
+        return self.expected - self.received
+
+    @property
+    def pdr(self):
+        if self.max_seq is None:
+            return 0.0
+        return self.received / self.expected
+
+    def percentile(self, p):
+        target = p * self.received
+        cumulative = 0
+        for i, count in enumerate(self.hist):
+            cumulative += count
+            if count and cumulative >= target:
+                return (i + 1) * self.bin_us
+        return 0
+
+
+def samples(data):
+    """Payloads of a datagram: itself, or the samples of an aggregate."""
+    if not data or data[0] != AGG_MAGIC:
+        yield data
+        return
+    pos = 2
+    for _ in range(data[1] if len(data) > 1 else 0):
+        if pos >= len(data) or pos + 1 + data[pos] > len(data):
+            return                  # truncated
+        yield data[pos + 1:pos + 1 + data[pos]]
+        pos += 1 + data[pos]
+
+
+def print_header(out):
+    out.write("flow,Node ID,Generator,Source,Received,Duplicates,Reordered,"
+              "Lost,PDR,Delay p50 (us),Delay p90 (us),Delay p99 (us),"
+              "Delay max (us),Jitter (us),Datagrams\n")
+
+
+def print_flows(flows, out):
+    for (node, gen), f in sorted(flows.items()):
+        out.write("flow,%u,%s,%s,%u,%u,%u,%u,%.4f,%u,%u,%u,%u,%.0f,%u\n" % (
+            node, GENERATORS[gen] if gen < len(GENERATORS) else gen,
+            f.source, f.received, f.duplicates, f.reordered, f.lost, f.pdr,
+            f.percentile(0.5), f.percentile(0.9), f.percentile(0.99),
+            f.max_delay, f.jitter, f.datagrams))
+    out.flush()
+
+
+def print_histograms(flows, out):
+    out.write("delay_hist,Node ID,Generator,Bin start (us),Packets\n")
+    for (node, gen), f in sorted(flows.items()):
+        for i, count in enumerate(f.hist):
+            if count:
+                out.write("delay_hist,%u,%s,%u,%u\n" % (
+                    node, GENERATORS[gen] if gen < len(GENERATORS) else gen,
+                    i * f.bin_us, count))
+    out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--bind", default="::", help="address to listen on")
+    parser.add_argument("--port", type=int, default=1337,
+                        help="UDP port (server_port of the nodes)")
+    parser.add_argument("--interval", type=float, default=0,
+                        help="print the flows every INTERVAL seconds")
+    parser.add_argument("--bin-us", type=int, default=1000,
+                        help="width of the delay histogram bins")
+    parser.add_argument("--bins", type=int, default=10000,
+                        help="number of delay histogram bins")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+    sock.bind((args.bind, args.port))
+    if args.interval:
+        sock.settimeout(args.interval)
+
+    flows = {}
+    ignored = 0
+    next_report = time.monotonic() + args.interval
+    signal.signal(signal.SIGTERM, lambda *_: sys.exit(0))
+    print_header(sys.stdout)
+    try:
+        while True:
+            try:
+                data, addr = sock.recvfrom(2048)
+            except socket.timeout:
+                data = None
+            rx_us = time.monotonic_ns() // 1000
+            if data is not None:
+                counted = set()
+                for sample in samples(data):
+                    if len(sample) < HDR.size or sample[0] != HDR_MAGIC:
+                        ignored += 1
+                        continue
+                    _, gen, node, seq, tx = HDR.unpack_from(sample)
+                    flow = flows.get((node, gen))
+                    if flow is None:
+                        source = ipaddress.ip_address(addr[0].split("%")[0])
+                        if source.ipv4_mapped:
+                            source = source.ipv4_mapped
+                        flow = Flow(source, args.bin_us, args.bins)
+                        flows[(node, gen)] = flow
+                    flow.add(seq, tx, rx_us)
+                    if (node, gen) not in counted:
+                        counted.add((node, gen))
+                        flow.datagrams += 1
+            if args.interval and time.monotonic() >= next_report:
+                next_report += args.interval
+                print_flows(flows, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print_flows(flows, sys.stdout)
+        print_histograms(flows, sys.stdout)
+        if ignored:
+            sys.stderr.write("%u packets without payload header\n" % ignored)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Measure the uplink of gnrc_border_router built with `USE_UDP_ECHO=1`.
+
+The border router sends every UDP datagram it receives on its echo port
+back to the sender. For every payload size and offered rate, this tool
+sends `--count` datagrams at that rate and matches the echoes. It then
+prints one line per step with the loss, the achieved rate and the
+round-trip time:
+
+    uplink_bench,Size,Offered (pkt/s),Sent,Received,Loss (%),Throughput (pkt/s),RTT min (ms),RTT p50 (ms),RTT p99 (ms),RTT max (ms)
+
+Send and receive times come from the host clock, so no clock
+synchronisation is needed. Each datagram crosses the uplink twice. On
+`BOARD=native` the uplink is the TAP interface. With ethos it is the
+serial line, and a run with `ETHOS_BATCH=0` can be compared with one with
+`ETHOS_BATCH=1`. An offered rate of 0 sends as fast as the socket accepts.
+
+    uplink_bench.py fe80::2%tap0 --sizes 16,64,256,1024 --rates 50,200,1000
+"""
+
+import argparse
+import select
+import socket
+import struct
+import sys
+import time
+
+HDR = struct.Struct("<HHIQ")
+HDR_MAGIC = 0xB0E1
+
+
+def percentile(values, p):
+    """Nearest-rank percentile of sorted values."""
+    if not values:
+        return None
+    rank = max(0, min(len(values) - 1, int(round(p / 100 * len(values))) - 1))
+    return values[rank]
+
+
+def run_step(sock, target, step, size, rate, count, timeout):
+    """Sends count datagrams of size bytes at rate pkt/s and collects the
+    echoes. Returns the send times, the round-trip times in ns and the time
+    of the last echo."""
+    sent = {}
+    rtts = []
+    last_rx = None
+    padding = bytes(size - HDR.size)
+    interval = int(1e9 / rate) if rate else 0
+    start = time.monotonic_ns()
+    deadline = None
+    seq = 0
+
+    while True:
+        now = time.monotonic_ns()
+        if seq < count:
+            due = start + seq * interval
+            wait = max(0, due - now) / 1e9
+        else:
+            if deadline is None:
+                deadline = now + int(timeout * 1e9)
+            if now >= deadline or len(rtts) == count:
+                break
+            wait = (deadline - now) / 1e9
+        readable, _, _ = select.select([sock], [], [], wait)
+        if readable:
+            data = sock.recv(65535)
+            now = time.monotonic_ns()
+            if len(data) < HDR.size:
+                continue
+            magic, rx_step, rx_seq, _ = HDR.unpack_from(data)
+            if magic != HDR_MAGIC or rx_step != step:
+                continue
+            tx = sent.pop(rx_seq, None)
+            if tx is not None:
+                rtts.append(now - tx)
+                last_rx = now
+            continue
+        if seq < count:
+            now = time.monotonic_ns()
+            try:
+                sock.sendto(HDR.pack(HDR_MAGIC, step, seq, now) + padding,
+                            target)
+            except BlockingIOError:
+                # the socket buffer is full, try again later
+                continue
+            sent[seq] = now
+            seq += 1
+    return start, rtts, last_rx
+
+
+def print_header(out):
+    out.write("uplink_bench,Size,Offered (pkt/s),Sent,Received,Loss (%),"
+              "Throughput (pkt/s),RTT min (ms),RTT p50 (ms),RTT p99 (ms),"
+              "RTT max (ms)\n")
+
+
+def print_step(out, size, rate, count, start, rtts, last_rx):
+    received = len(rtts)
+    loss = 100.0 * (count - received) / count
+    line = "uplink_bench,%u,%u,%u,%u,%.2f," % (size, rate, count, received,
+                                              loss)
+    if received > 1:
+        line += "%.1f," % (received * 1e9 / (last_rx - start))
+    else:
+        line += ","
+    if rtts:
+        rtts.sort()
+        line += ",".join("%.3f" % (v / 1e6) for v in
+                         (rtts[0], percentile(rtts, 50), percentile(rtts, 99),
+                          rtts[-1]))
+    else:
+        line += ",,,"
+    out.write(line + "\n")
+    out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("address", help="address of the border router, "
+                        "with %%interface for a link-local one")
+    parser.add_argument("--port", type=int, default=7,
+                        help="UDP_ECHO_PORT of the border router")
+    parser.add_argument("--sizes", default="16,64,256,1024",
+                        help="comma separated UDP payload sizes in bytes")
+    parser.add_argument("--rates", default="50,100,200,500,1000",
+                        help="comma separated offered rates in pkt/s, "
+                        "0 for as fast as possible")
+    parser.add_argument("--count", type=int, default=500,
+                        help="datagrams per size and rate")
+    parser.add_argument("--timeout", type=float, default=2.0,
+                        help="seconds to wait for the last echoes of a step")
+    parser.add_argument("--pause", type=float, default=1.0,
+                        help="seconds between two steps, to drain the queues")
+    args = parser.parse_args()
+
+    sizes = [int(v) for v in args.sizes.split(",")]
+    rates = [int(v) for v in args.rates.split(",")]
+    if min(sizes) < HDR.size:
+        parser.error("sizes must be at least %u bytes" % HDR.size)
+
+    info = socket.getaddrinfo(args.address, args.port, socket.AF_INET6,
+                              socket.SOCK_DGRAM)
+    target = info[0][4]
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    sock.setblocking(False)
+
+    print_header(sys.stdout)
+    step = 0
+    try:
+        for size in sizes:
+            for rate in rates:
+                start, rtts, last_rx = run_step(sock, target, step, size, rate,
+                                                args.count, args.timeout)
+                print_step(sys.stdout, size, rate, args.count, start, rtts,
+                           last_rx)
+                step = (step + 1) & 0xFFFF
+                time.sleep(args.pause)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
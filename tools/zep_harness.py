@@ -0,0 +1,458 @@
+#!/usr/bin/env python3
+"""Emulate a network of native gnrc_networking nodes and a border router.
+
+One gnrc_border_router and N gnrc_networking instances are started as
+`BOARD=native` processes on this machine. Their ZEP radios are connected
+by a dispatcher that forwards every frame along the links of a topology
+file and drops it with the loss of the link:
+
+    # node <name> [br] [server=<addr>] [type=<type>] [rate=<pkt/s>]
+    #      [period=<s>] [size=<bytes>]
+    node br br
+    node n1
+    node n2 type=PERIODIC period=5
+    # link <a> <b> <loss a to b> [<loss b to a>]
+    link br n1 0.05
+    link n1 n2 0.1 0.2
+
+Node i of the file gets the ZEP port `--port` + 1 + i, the native instance
+id i + 1 (its CPU id, so its link-layer addresses) and the seed
+(`--seed` << 16) + i. The dispatcher draws the loss of every link from its
+own generator seeded from `--seed` and the names of both ends. A run with
+the same file and seed therefore gives every node the same addresses,
+random numbers and sequence of lost frames; only the timing of the
+processes differs.
+
+The border router is configured from its shell once it is up. It gets the
+address <prefix>1 and becomes the RPL root on its ZEP interface. The nodes
+are then started one every `--stagger` seconds and fed the five lines of
+their boot configuration: server address, generation type, exponential
+rate, period and payload size. The defaults of the `--server`, `--type`,
+`--rate`, `--period` and `--size` options can be overridden per node in
+the topology file. The output of every instance goes to
+<out>/<name>.log with the `<time>;<node>;` prefix of the IoT-LAB
+aggregator, so tools/log_analyzer reads it as is. The dispatcher counters
+go to <out>/dispatch.log and the instance parameters to <out>/nodes.csv.
+After `--duration` seconds the `--final` commands run on the border router
+(default: `udp_sink`, `fwdstats`) and everything is stopped.
+
+The dispatcher and the instances are pinned round-robin to the CPUs this
+process may use (see `--cpus`), so a few hundred nodes fit on a
+workstation. Build both firmwares for native with ZEP only, so that no
+TAP interface is needed:
+
+    make -C src/gnrc_border_router BOARD=native ZEP_ONLY=1 USE_UDP_SINK=1
+    make -C src/gnrc_networking BOARD=native USE_ZEP=1 ZEP_ONLY=1 PAYLOAD_HEADER=1
+    zep_harness.py topo grid 10x10 --loss 0.05 > grid.topo
+    zep_harness.py run grid.topo --duration 600 --out run1
+"""
+
+import argparse
+import os
+import random
+import re
+import resource
+import selectors
+import signal
+import socket
+import subprocess
+import sys
+import time
+
+NODE_KEYS = ("server", "type", "rate", "period", "size")
+ROOT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BR_ELF = os.path.join(ROOT_DIR, "src/gnrc_border_router/bin/native/"
+                      "gnrc_border_router.elf")
+NODE_ELF = os.path.join(ROOT_DIR, "src/gnrc_networking/bin/native/"
+                        "gnrc_networking.elf")
+BR_SETUP = ["ifconfig {iface} add {prefix}1/64",
+            "rpl init {iface}",
+            "rpl root 1 {prefix}1"]
+BR_FINAL = ["udp_sink", "fwdstats"]
+BR_UP = "All up, running the shell now"
+IFACE_RE = re.compile(r"^Iface\s+(\d+)")
+
+
+class Topology:
+    """Nodes in file order and directed links with their loss."""
+
+    def __init__(self):
+        self.nodes = []  # (name, is_br, {key: value})
+        self.links = {}  # (from, to): loss
+
+    def names(self):
+        return [node[0] for node in self.nodes]
+
+    def border_router(self):
+        for index, (name, is_br, _) in enumerate(self.nodes):
+            if is_br:
+                return index
+        return None
+
+
+def load_topology(path):
+    topo = Topology()
+    known = set()
+
+    def fail(lineno, msg):
+        sys.exit("%s:%u: %s" % (path, lineno, msg))
+
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            if fields[0] == "node" and len(fields) >= 2:
+                name = fields[1]
+                is_br = False
+                config = {}
+                if name in known:
+                    fail(lineno, "duplicate node %s" % name)
+                for field in fields[2:]:
+                    key, sep, value = field.partition("=")
+                    if field == "br":
+                        is_br = True
+                    elif sep and key in NODE_KEYS:
+                        config[key] = value
+                    else:
+                        fail(lineno, "unknown node option %s" % field)
+                known.add(name)
+                topo.nodes.append((name, is_br, config))
+            elif fields[0] == "link" and len(fields) in (4, 5):
+                a, b = fields[1], fields[2]
+                for name in (a, b):
+                    if name not in known:
+                        fail(lineno, "link to undeclared node %s" % name)
+                try:
+                    loss = [float(v) for v in fields[3:]]
+                except ValueError:
+                    fail(lineno, "invalid loss")
+                if not all(0 <= v <= 1 for v in loss):
+                    fail(lineno, "loss must be between 0 and 1")
+                topo.links[(a, b)] = loss[0]
+                topo.links[(b, a)] = loss[-1]
+            else:
+                fail(lineno, "expected node or link")
+    if sum(1 for node in topo.nodes if node[1]) != 1:
+        sys.exit("%s: exactly one node must be the border router (br)" % path)
+    return topo
+
+
+def zep_port(base, index):
+    return base + 1 + index
+
+
+def cmd_topo(args):
+    """Prints a line or grid topology, with the border router at one end."""
+    if args.shape == "line":
+        count = int(args.size)
+        coords = [(x, 0) for x in range(count + 1)]
+    else:
+        width, _, height = args.size.partition("x")
+        coords = [(x, y) for y in range(int(height)) for x in range(int(width))]
+    names = {}
+    for index, coord in enumerate(coords):
+        names[coord] = "br" if index == 0 else "n%u" % index
+        print("node %s%s" % (names[coord], " br" if index == 0 else ""))
+    for (x, y), name in names.items():
+        for neighbor in ((x + 1, y), (x, y + 1)):
+            if neighbor in names:
+                print("link %s %s %g" % (name, names[neighbor], args.loss))
+
+
+def bind_dispatcher(port):
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 22)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 1 << 22)
+    sock.bind(("::1", port))
+    return sock
+
+
+def cmd_dispatch(args):
+    """Forwards the ZEP frames along the links of the topology."""
+    topo = load_topology(args.topology)
+    ports = {name: zep_port(args.port, i)
+             for i, name in enumerate(topo.names())}
+    names = {port: name for name, port in ports.items()}
+    neighbors = {port: [] for port in names}
+    for (a, b), loss in sorted(topo.links.items()):
+        rng = random.Random("%u:%s:%s" % (args.seed, a, b))
+        neighbors[ports[a]].append((ports[b], loss, rng))
+    received = forwarded = dropped = unknown = 0
+
+    if args.fd is not None:
+        sock = socket.socket(fileno=args.fd)
+    else:
+        sock = bind_dispatcher(args.port)
+
+    def report(*_):
+        print("dispatch,Frames received,Frames forwarded,Frames dropped,"
+              "Unknown sources")
+        print("dispatch,%u,%u,%u,%u" % (received, forwarded, dropped, unknown))
+        sys.stdout.flush()
+        os._exit(0)
+
+    signal.signal(signal.SIGTERM, report)
+    signal.signal(signal.SIGINT, report)
+    while True:
+        data, addr = sock.recvfrom(65535)
+        links = neighbors.get(addr[1])
+        if links is None:
+            unknown += 1
+            continue
+        received += 1
+        for port, loss, rng in links:
+            if loss and rng.random() < loss:
+                dropped += 1
+                continue
+            sock.sendto(data, ("::1", port))
+            forwarded += 1
+
+
+class Instance:
+    """A native process, its pinned CPU and its log."""
+
+    def __init__(self, name, argv, out, cpu):
+        self.name = name
+        self.partial = b""
+        self.log = open(os.path.join(out, name + ".log"), "w")
+        self.proc = subprocess.Popen(argv, stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT, bufsize=0,
+                                     start_new_session=True)
+        os.sched_setaffinity(self.proc.pid, {cpu})
+
+    def send(self, line):
+        try:
+            self.proc.stdin.write((line + "\n").encode())
+        except BrokenPipeError:
+            pass
+
+    def feed(self, data):
+        """Logs the complete lines of data and returns them."""
+        now = time.time()
+        lines = (self.partial + data).split(b"\n")
+        self.partial = lines.pop()
+        lines = [l.rstrip(b"\r").decode(errors="replace") for l in lines]
+        for line in lines:
+            self.log.write("%.6f;%s;%s\n" % (now, self.name, line))
+        return lines
+
+    def stop(self):
+        if self.proc.poll() is None:
+            try:
+                os.killpg(self.proc.pid, signal.SIGTERM)
+            except ProcessLookupError:
+                pass
+
+
+def parse_cpus(spec):
+    cpus = set()
+    for part in spec.split(","):
+        first, _, last = part.partition("-")
+        cpus.update(range(int(first), int(last or first) + 1))
+    return sorted(cpus)
+
+
+def cmd_run(args):
+    topo = load_topology(args.topology)
+    br_index = topo.border_router()
+    cpus = parse_cpus(args.cpus) if args.cpus else \
+        sorted(os.sched_getaffinity(0))
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    if soft < hard:
+        # a pipe each way and a log per instance
+        resource.setrlimit(resource.RLIMIT_NOFILE, (hard, hard))
+    os.makedirs(args.out, exist_ok=True)
+
+    defaults = {"server": args.server or args.prefix + "1", "type": args.type,
+                "rate": args.rate, "period": args.period, "size": args.size}
+    params = []
+    with open(os.path.join(args.out, "nodes.csv"), "w") as f:
+        f.write("name,role,id,seed,zep_port,cpu\n")
+        for index, (name, is_br, _) in enumerate(topo.nodes):
+            # the dispatcher keeps cpus[0] for itself if there is another one
+            cpu = cpus[(index + 1) % len(cpus)]
+            seed = ((args.seed << 16) + index) & 0xFFFFFFFF
+            params.append((index + 1, seed, zep_port(args.port, index), cpu))
+            f.write("%s,%s,%u,%u,%u,%u\n" % ((name, "br" if is_br else "node")
+                                             + params[-1]))
+
+    def argv(elf, index):
+        native_id, seed, port, _ = params[index]
+        return [elf, "-i", str(native_id), "-s", str(seed),
+                "-z", "[::1]:%u,[::1]:%u" % (port, args.port)]
+
+    # bound here, so that no instance starts before the dispatcher listens
+    sock = bind_dispatcher(args.port)
+    dispatch_log = open(os.path.join(args.out, "dispatch.log"), "w")
+    dispatcher = subprocess.Popen(
+        [sys.executable, os.path.abspath(__file__), "dispatch", args.topology,
+         "--port", str(args.port), "--seed", str(args.seed),
+         "--fd", str(sock.fileno())],
+        stdout=dispatch_log, stderr=subprocess.STDOUT,
+        pass_fds=[sock.fileno()])
+    sock.close()
+    os.sched_setaffinity(dispatcher.pid, {cpus[0]})
+
+    sel = selectors.DefaultSelector()
+    instances = []
+
+    def start(index, elf):
+        name = topo.nodes[index][0]
+        inst = Instance(name, argv(elf, index), args.out, params[index][3])
+        sel.register(inst.proc.stdout, selectors.EVENT_READ, inst)
+        instances.append(inst)
+        return inst
+
+    br = start(br_index, args.br_elf)
+    br_state = "boot"
+    br_iface = args.br_iface
+    pending = [i for i in range(len(topo.nodes)) if i != br_index]
+    next_start = None
+    end = None
+    deadline = time.monotonic() + args.boot_timeout
+    finished = None
+
+    try:
+        while True:
+            now = time.monotonic()
+            if br_state != "up" and now >= deadline:
+                sys.exit("the border router was not up after %g s"
+                         % args.boot_timeout)
+            if next_start is not None and pending and now >= next_start:
+                index = pending.pop(0)
+                node = start(index, args.node_elf)
+                config = dict(defaults, **topo.nodes[index][2])
+                for key in NODE_KEYS:
+                    node.send(str(config[key]))
+                next_start = now + args.stagger
+                if not pending:
+                    end = now + args.duration
+                    sys.stderr.write("all %u nodes started, running for "
+                                     "%g s\n" % (len(instances) - 1,
+                                                 args.duration))
+            if end is not None and finished is None and now >= end:
+                for command in args.final or BR_FINAL:
+                    br.send(command)
+                finished = now + args.drain
+            if finished is not None and now >= finished:
+                break
+            for key, _ in sel.select(timeout=0.05):
+                inst = key.data
+                data = os.read(key.fd, 65536)
+                if not data:
+                    sel.unregister(key.fileobj)
+                    sys.stderr.write("%s exited\n" % inst.name)
+                    continue
+                lines = inst.feed(data)
+                if inst is not br or br_state == "up":
+                    continue
+                for line in lines:
+                    if br_state == "boot" and BR_UP in line:
+                        if br_iface is None:
+                            br.send("ifconfig")
+                            br_state = "ifconfig"
+                            continue
+                    elif br_state == "ifconfig":
+                        match = IFACE_RE.match(line.strip())
+                        if match is None:
+                            continue
+                        br_iface = int(match.group(1))
+                    else:
+                        continue
+                    for command in args.setup or BR_SETUP:
+                        br.send(command.format(iface=br_iface,
+                                               prefix=args.prefix))
+                    br_state = "up"
+                    next_start = time.monotonic()
+                    if not pending:
+                        end = next_start + args.duration
+                    break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for inst in instances:
+            inst.stop()
+        dispatcher.send_signal(signal.SIGTERM)
+        time.sleep(0.5)
+        for inst in instances:
+            if inst.proc.poll() is None:
+                os.killpg(inst.proc.pid, signal.SIGKILL)
+            inst.proc.wait()
+            inst.log.close()
+        dispatcher.wait()
+        dispatch_log.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    topo = sub.add_parser("topo", help="print a line or grid topology")
+    topo.add_argument("shape", choices=["line", "grid"])
+    topo.add_argument("size", help="nodes behind the border router for a "
+                      "line, <width>x<height> for a grid")
+    topo.add_argument("--loss", type=float, default=0.0,
+                      help="loss of every link")
+    topo.set_defaults(func=cmd_topo)
+
+    dispatch = sub.add_parser("dispatch",
+                              help="only run the ZEP dispatcher")
+    dispatch.add_argument("topology")
+    dispatch.add_argument("--port", type=int, default=17754)
+    dispatch.add_argument("--seed", type=int, default=1)
+    dispatch.add_argument("--fd", type=int,
+                          help="use this bound socket instead of the port")
+    dispatch.set_defaults(func=cmd_dispatch)
+
+    run = sub.add_parser("run", help="run the emulation")
+    run.add_argument("topology")
+    run.add_argument("--out", default="zep_run",
+                     help="directory of the logs")
+    run.add_argument("--duration", type=float, default=300,
+                     help="seconds to run once all nodes are started")
+    run.add_argument("--seed", type=int, default=1,
+                     help="seed of the nodes and of the link losses")
+    run.add_argument("--port", type=int, default=17754,
+                     help="UDP port of the dispatcher, the nodes use the "
+                     "following ones")
+    run.add_argument("--cpus", help="CPUs to pin to, e.g. 0-7,16-23 "
+                     "(default: all this process may use)")
+    run.add_argument("--stagger", type=float, default=0.05,
+                     help="seconds between two node starts")
+    run.add_argument("--br-elf", default=BR_ELF)
+    run.add_argument("--node-elf", default=NODE_ELF)
+    run.add_argument("--br-iface", type=int,
+                     help="ZEP interface of the border router "
+                     "(default: the first one of `ifconfig`)")
+    run.add_argument("--prefix", default="2001:db8::",
+                     help="prefix of the network, ends with ::")
+    run.add_argument("--setup", action="append",
+                     help="border router setup command, with {iface} and "
+                     "{prefix} (repeat; default: %s)" % "; ".join(BR_SETUP))
+    run.add_argument("--final", action="append",
+                     help="border router command at the end (repeat; "
+                     "default: %s)" % "; ".join(BR_FINAL))
+    run.add_argument("--drain", type=float, default=2.0,
+                     help="seconds of output kept after the final commands")
+    run.add_argument("--boot-timeout", type=float, default=30.0,
+                     help="seconds for the border router to come up")
+    run.add_argument("--server", help="boot config: server address "
+                     "(default: <prefix>1, the border router)")
+    run.add_argument("--type", default="PERIODIC",
+                     help="boot config: generation type")
+    run.add_argument("--rate", default="0.1",
+                     help="boot config: exponential rate in packets/s")
+    run.add_argument("--period", default="10",
+                     help="boot config: period in s")
+    run.add_argument("--size", default="32",
+                     help="boot config: payload size in bytes")
+    run.set_defaults(func=cmd_run)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()